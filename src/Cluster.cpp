@@ -0,0 +1,554 @@
+#include "Cluster.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+using Clock = std::chrono::steady_clock;
+
+static long long msSince(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t).count();
+}
+
+bool LineReader::fill() {
+    char buf[4096];
+    ssize_t n;
+    do {
+        n = ::read(fd, buf, sizeof(buf));
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return false;
+    pending.append(buf, static_cast<size_t>(n));
+    return true;
+}
+
+bool LineReader::pop(std::string &line) {
+    size_t nl = pending.find('\n');
+    if (nl == std::string::npos) return false;
+    line = pending.substr(0, nl);
+    pending.erase(0, nl + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
+
+bool LineReader::next(std::string &line) {
+    while (!pop(line)) {
+        if (!fill()) {
+            if (pending.empty()) return false;
+            line.swap(pending);
+            pending.clear();
+            return true;
+        }
+    }
+    return true;
+}
+
+bool LineReader::next(std::string &line, int timeoutMs) {
+    while (!pop(line)) {
+        pollfd pfd{fd, POLLIN, 0};
+        int ready;
+        do {
+            ready = ::poll(&pfd, 1, timeoutMs);
+        } while (ready < 0 && errno == EINTR);
+        if (ready <= 0 || !fill()) return false;
+    }
+    return true;
+}
+
+bool writeLine(int fd, const std::string &line) {
+    std::string msg = line + "\n";
+    bool isSocket = true;
+    size_t off = 0;
+    while (off < msg.size()) {
+        ssize_t n = isSocket ? ::send(fd, msg.data() + off, msg.size() - off, MSG_NOSIGNAL)
+                             : ::write(fd, msg.data() + off, msg.size() - off);
+        if (n < 0 && errno == ENOTSOCK && isSocket) {
+            isSocket = false;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        off += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// "unix:/path" or "host:port"; returns a listening or connected socket, -1 on failure
+static int openSocket(const std::string &address, bool listening) {
+    const std::string unixPrefix = "unix:";
+    if (address.compare(0, unixPrefix.size(), unixPrefix) == 0) {
+        std::string path = address.substr(unixPrefix.size());
+        sockaddr_un sa{};
+        if (path.empty() || path.size() >= sizeof(sa.sun_path)) return -1;
+        sa.sun_family = AF_UNIX;
+        std::memcpy(sa.sun_path, path.c_str(), path.size() + 1);
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        bool ok;
+        if (listening) {
+            ::unlink(path.c_str());
+            ok = ::bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) == 0 && ::listen(fd, 64) == 0;
+        } else {
+            ok = ::connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) == 0;
+        }
+        if (!ok) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) return -1;
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = listening ? AI_PASSIVE : 0;
+    addrinfo *res = nullptr;
+    if (::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        bool ok;
+        if (listening) {
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            ok = ::bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && ::listen(fd, 64) == 0;
+        } else {
+            ok = ::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0;
+            if (ok) ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (ok) break;
+        ::close(fd);
+        fd = -1;
+    }
+    ::freeaddrinfo(res);
+    return fd;
+}
+
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+// Serves jobs read from inFd, answering on outFd, until QUIT or EOF
+static int serveJobs(int inFd, int outFd, const ClusterConfig &config) {
+    std::mutex writeMutex;
+    std::mutex stopMutex;
+    std::condition_variable stopCv;
+    bool stopping = false;
+
+    auto send = [&](const std::string &line) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return writeLine(outFd, line);
+    };
+
+    send("HELLO " + std::to_string(::getpid()));
+
+    // Heartbeats keep flowing while a long search is running; the coordinator
+    // sends the interval to use, a third of its timeout at most, and a new one
+    // cuts the current wait short
+    int heartbeatMs = config.heartbeatMs;
+    std::thread heartbeat([&]() {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopping) {
+            int ms = heartbeatMs;
+            if (stopCv.wait_for(lock, std::chrono::milliseconds(ms), [&] { return stopping || heartbeatMs != ms; })) {
+                continue;
+            }
+            if (!send("HB")) break;
+        }
+    });
+
+    ChessEngine engine;
+    engine.setHashSize(config.hashMb);
+    LineReader reader(inFd);
+    std::string line;
+    while (reader.next(line)) {
+        std::istringstream in(line);
+        std::string cmd;
+        in >> cmd;
+        if (cmd == "QUIT") break;
+        if (cmd == "HEARTBEAT") {
+            int ms;
+            if (in >> ms && ms > 0) {
+                std::lock_guard<std::mutex> lock(stopMutex);
+                heartbeatMs = ms;
+            }
+            stopCv.notify_all();
+            continue;
+        }
+        if (cmd != "JOB") continue;
+
+        unsigned long long id;
+        int depth;
+        long long timeMs;
+        uint64_t nodeLimit;
+        std::string fen;
+        in >> id >> depth >> timeMs >> nodeLimit;
+        std::getline(in >> std::ws, fen);
+
+        Board board;
+        std::ostringstream out;
+        out << "RESULT " << id << " ";
+        if (!in || !boardFromFen(fen, board)) {
+            out << "0000 0 0 0 0";
+        } else if (engine.generateLegalMoves(board).empty()) {
+            // Scored as the search scores it at this depth, and complete to that depth
+            int score = engine.isKingInCheck(board, board.whiteToMove) ? matedScore(depth) : 0;
+            out << "0000 " << score << " " << depth << " 0 0";
+        } else {
+            Move best = engine.findBestMove(board, depth, timeMs / 1000.0, nodeLimit);
+            const SearchStats &stats = engine.getLastStats();
+            out << moveToString(best) << " " << stats.score << " " << stats.depth << " "
+                << stats.nodes << " " << static_cast<long long>(stats.elapsedSec * 1000);
+        }
+        if (!send(out.str())) break;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCv.notify_all();
+    heartbeat.join();
+    return 0;
+}
+
+int runWorker(const ClusterConfig &config) {
+    if (config.address == "stdio") {
+        return serveJobs(STDIN_FILENO, STDOUT_FILENO, config);
+    }
+
+    // The coordinator may still be starting up
+    int fd = -1;
+    for (int attempt = 0; attempt < 50 && fd < 0; ++attempt) {
+        fd = openSocket(config.address, false);
+        if (fd < 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (fd < 0) {
+        std::cerr << "worker: cannot connect to " << config.address << "\n";
+        return 1;
+    }
+    int rc = serveJobs(fd, fd, config);
+    ::close(fd);
+    return rc;
+}
+
+
+// ---------------------------------------------------------------------------
+// Coordinator
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// A job whose worker is lost this many times is reported as failed, not handed out again
+constexpr int MAX_JOB_ATTEMPTS = 3;
+
+struct Job {
+    unsigned long long id;
+    unsigned long long task;  // Sequence number of the owning task
+    std::string fen;
+    std::string rootMove;     // Set when the job is one root-move subtree
+    int depth;
+    int attempts = 0;         // Workers lost while running it
+};
+
+struct Task {
+    std::string fen;
+    size_t outstanding;
+    std::string bestMove;
+    int bestScore;
+    int depth;
+    uint64_t nodes;
+    bool failed = false;      // A job gave up; the task is reported as failed
+};
+
+struct WorkerConn {
+    int fd;
+    LineReader reader;
+    bool busy;
+    Job job;
+    Clock::time_point lastSeen;
+};
+
+class Coordinator {
+public:
+    // Several heartbeats must fit in the timeout, or a healthy worker is dropped before its first one arrives
+    explicit Coordinator(const ClusterConfig &config)
+        : config(config), heartbeatMs(std::max(1, std::min(config.heartbeatMs, config.workerTimeoutMs / 3))),
+          input(STDIN_FILENO) {}
+
+    int run();
+
+private:
+    void addTask(const std::string &fen);
+    void handleResult(WorkerConn &w, std::istringstream &in);
+    void dropWorker(size_t index, const char *reason);
+    void failJob(const Job &job);
+    void dispatch();
+    void flushTasks();
+    void pumpInput();
+
+    const ClusterConfig &config;
+    int heartbeatMs;
+    EngineCore engine;
+    LineReader input;
+    bool inputOpen = true;
+
+    std::deque<Job> queue;
+    std::deque<Task> tasks;
+    unsigned long long firstTask = 0;
+    unsigned long long nextJobId = 1;
+    std::vector<WorkerConn> workers;
+};
+
+void Coordinator::addTask(const std::string &fen) {
+    Board board;
+    if (!boardFromFen(fen, board)) {
+        std::cerr << "coordinator: bad FEN: " << fen << "\n";
+        return;
+    }
+
+    unsigned long long seq = firstTask + tasks.size();
+    tasks.push_back(Task{boardToFen(board), 0, "0000", -INFINITY_SCORE, 0, 0});
+    Task &task = tasks.back();
+
+    if (!config.splitRoot) {
+        queue.push_back(Job{nextJobId++, seq, task.fen, "", config.depth});
+        task.outstanding = 1;
+        return;
+    }
+
+    auto moves = engine.generateLegalMoves(board);
+    if (moves.empty()) {
+        task.bestScore = engine.isKingInCheck(board, board.whiteToMove) ? matedScore(config.depth) : 0;
+        task.depth = config.depth;
+        return;
+    }
+    // Lowered to the shallowest root job as results arrive
+    task.depth = std::numeric_limits<int>::max();
+    for (auto &m : moves) {
+        Piece captured = board.squares[m.toRow()][m.toCol()];
+        engine.makeMove(board, m);
+        queue.push_back(Job{nextJobId++, seq, boardToFen(board), moveToString(m), std::max(1, config.depth - 1)});
+        engine.undoMove(board, m, captured);
+    }
+    task.outstanding = moves.size();
+}
+
+void Coordinator::handleResult(WorkerConn &w, std::istringstream &in) {
+    unsigned long long id;
+    std::string move;
+    int score, depth;
+    uint64_t nodes;
+    long long ms;
+    in >> id >> move >> score >> depth >> nodes >> ms;
+    if (!in || !w.busy || id != w.job.id) return;  // Stale or malformed
+
+    w.busy = false;
+    Task &task = tasks[w.job.task - firstTask];
+    task.nodes += nodes;
+    if (w.job.rootMove.empty()) {
+        task.bestMove  = move;
+        task.bestScore = score;
+        task.depth     = depth;
+    } else {
+        // The split search is only as deep as its shallowest root move
+        task.depth = std::min(task.depth, depth + 1);
+        if (-score > task.bestScore) {
+            task.bestMove  = w.job.rootMove;
+            task.bestScore = -score;
+        }
+    }
+    --task.outstanding;
+}
+
+void Coordinator::dropWorker(size_t index, const char *reason) {
+    WorkerConn &w = workers[index];
+    std::cerr << "coordinator: dropping worker (" << reason << ")";
+    if (w.busy && ++w.job.attempts >= MAX_JOB_ATTEMPTS) {
+        std::cerr << ", job " << w.job.id << " failed on " << w.job.attempts << " workers";
+        failJob(w.job);
+    } else if (w.busy) {
+        std::cerr << ", reassigning job " << w.job.id;
+        queue.push_front(w.job);
+    }
+    std::cerr << "\n";
+    ::close(w.fd);
+    workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void Coordinator::failJob(const Job &job) {
+    Task &task = tasks[job.task - firstTask];
+    task.failed = true;
+    --task.outstanding;
+}
+
+void Coordinator::dispatch() {
+    for (size_t i = 0; i < workers.size() && !queue.empty();) {
+        WorkerConn &w = workers[i];
+        if (w.busy) {
+            ++i;
+            continue;
+        }
+        Job job = queue.front();
+        queue.pop_front();
+        std::ostringstream msg;
+        msg << "JOB " << job.id << " " << job.depth << " "
+            << static_cast<long long>(config.timeLimit * 1000) << " " << config.nodeLimit << " " << job.fen;
+        w.job  = job;
+        w.busy = true;
+        if (!writeLine(w.fd, msg.str())) {
+            dropWorker(i, "send failed");
+            continue;
+        }
+        ++i;
+    }
+}
+
+void Coordinator::flushTasks() {
+    while (!tasks.empty() && tasks.front().outstanding == 0) {
+        const Task &t = tasks.front();
+        if (t.failed) {
+            std::cout << t.fen << " failed" << std::endl;
+        } else {
+            std::cout << t.fen << " bestmove " << t.bestMove << " score " << t.bestScore
+                      << " depth " << t.depth << " nodes " << t.nodes << std::endl;
+        }
+        tasks.pop_front();
+        ++firstTask;
+    }
+}
+
+// Backpressure: lines stay in the input buffer until the job queue has room
+void Coordinator::pumpInput() {
+    std::string line;
+    while (queue.size() < config.maxQueuedJobs && input.pop(line)) {
+        if (!line.empty()) addTask(line);
+    }
+    if (!inputOpen && queue.size() < config.maxQueuedJobs && !input.buffer().empty()) {
+        line.swap(input.buffer());
+        input.buffer().clear();
+        if (!line.empty()) addTask(line);
+    }
+}
+
+int Coordinator::run() {
+    if (heartbeatMs < config.heartbeatMs) {
+        std::cerr << "coordinator: heartbeat lowered to " << heartbeatMs << " ms to fit the " << config.workerTimeoutMs
+                  << " ms timeout\n";
+    }
+    int listenFd = openSocket(config.address, true);
+    if (listenFd < 0) {
+        std::cerr << "coordinator: cannot listen on " << config.address << "\n";
+        return 1;
+    }
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < config.spawnWorkers; ++i) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(listenFd);
+            ::close(STDIN_FILENO);
+            ::_exit(runWorker(config));
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+
+    while (inputOpen || !input.buffer().empty() || !tasks.empty()) {
+        std::vector<pollfd> fds;
+        fds.push_back(pollfd{listenFd, POLLIN, 0});
+        bool pollInput = inputOpen && queue.size() < config.maxQueuedJobs && !input.hasLine();
+        fds.push_back(pollfd{pollInput ? STDIN_FILENO : -1, POLLIN, 0});
+        for (auto &w : workers) fds.push_back(pollfd{w.fd, POLLIN, 0});
+
+        if (::poll(fds.data(), fds.size(), heartbeatMs) < 0 && errno != EINTR) break;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd >= 0 && writeLine(fd, "HEARTBEAT " + std::to_string(heartbeatMs))) {
+                workers.push_back(WorkerConn{fd, LineReader(fd), false, Job{}, Clock::now()});
+            } else if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        if (fds[1].revents & (POLLIN | POLLHUP)) {
+            if (!input.fill()) inputOpen = false;
+        }
+
+        // Worker fds start at index 2; walk backwards so drops do not shift unvisited entries
+        for (size_t i = fds.size(); i-- > 2;) {
+            if (!fds[i].revents) continue;
+            size_t wi = i - 2;
+            WorkerConn &w = workers[wi];
+            if (!w.reader.fill()) {
+                dropWorker(wi, "disconnected");
+                continue;
+            }
+            w.lastSeen = Clock::now();
+            std::string line;
+            while (w.reader.pop(line)) {
+                std::istringstream in(line);
+                std::string cmd;
+                in >> cmd;
+                if (cmd == "RESULT") handleResult(w, in);
+            }
+        }
+
+        for (size_t i = workers.size(); i-- > 0;) {
+            if (msSince(workers[i].lastSeen) > config.workerTimeoutMs) dropWorker(i, "heartbeat timeout");
+        }
+
+        // Forked workers are not replaced; once all of them are gone nothing will run the queue
+        children.erase(std::remove_if(children.begin(), children.end(),
+                                      [](pid_t pid) { return ::waitpid(pid, nullptr, WNOHANG) == pid; }),
+                       children.end());
+        if (config.spawnWorkers > 0 && children.empty() && workers.empty() && !queue.empty()) {
+            std::cerr << "coordinator: every worker is gone, failing " << queue.size() << " jobs\n";
+            for (const Job &job : queue) failJob(job);
+            queue.clear();
+        }
+
+        pumpInput();
+        dispatch();
+        flushTasks();
+    }
+
+    for (auto &w : workers) {
+        writeLine(w.fd, "QUIT");
+        ::close(w.fd);
+    }
+    ::close(listenFd);
+    if (config.address.compare(0, 5, "unix:") == 0) ::unlink(config.address.c_str() + 5);
+    for (pid_t pid : children) ::waitpid(pid, nullptr, 0);
+    return 0;
+}
+
+} // namespace
+
+int runCoordinator(const ClusterConfig &config) {
+    Coordinator coordinator(config);
+    return coordinator.run();
+}
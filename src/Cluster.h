@@ -0,0 +1,62 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "Engine.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Distributed analysis: a coordinator hands positions (or root-move subtrees)
+// to engine worker processes over TCP ("host:port") or Unix ("unix:/path") sockets.
+//
+// Line protocol, one message per line:
+//   worker -> coordinator   HELLO <pid>
+//                           HB
+//                           RESULT <jobId> <move> <score> <depth> <nodes> <ms>
+//   coordinator -> worker   HEARTBEAT <ms>
+//                           JOB <jobId> <depth> <timeMs> <nodes> <fen>   (nodes 0 = no limit)
+//                           QUIT
+struct ClusterConfig {
+    std::string address    = "127.0.0.1:7878";
+    int    depth           = MAX_DEPTH;
+    double timeLimit       = DEFAULT_TIME_LIMIT;
+    uint64_t nodeLimit     = 0;
+    size_t hashMb          = DEFAULT_HASH_MB;  // Per worker
+    bool   splitRoot       = false;  // One job per legal root move instead of one per position
+    int    spawnWorkers    = 0;      // Local worker processes forked by the coordinator
+    int    heartbeatMs     = 1000;
+    int    workerTimeoutMs = 5000;   // Silence after which a worker is presumed dead
+    size_t maxQueuedJobs   = 64;     // Input is not read while this many jobs are waiting
+};
+
+// Reads FEN lines from stdin, prints "<fen> bestmove <m> score <s> depth <d> nodes <n>"
+// lines to stdout in input order. A position whose job lost three workers, or was
+// still queued when every forked worker had died, prints "<fen> failed" instead.
+int runCoordinator(const ClusterConfig &config);
+
+// Connects to the coordinator and serves jobs until told to quit.
+// An address of "stdio" serves the same protocol on stdin/stdout.
+int runWorker(const ClusterConfig &config);
+
+// Buffered newline-delimited reader over a socket or pipe
+class LineReader {
+public:
+    explicit LineReader(int fd = -1) : fd(fd) {}
+
+    bool fill();                              // One read(); false on EOF or error
+    bool pop(std::string &line);              // Next buffered line, if any
+    bool next(std::string &line);             // Blocking; returns a final unterminated line at EOF
+    bool next(std::string &line, int timeoutMs);  // False on EOF, error or timeout
+
+    bool hasLine() const { return pending.find('\n') != std::string::npos; }
+    std::string &buffer() { return pending; }
+
+private:
+    int fd;
+    std::string pending;
+};
+
+// Writes line plus newline to a socket or pipe; false if the peer is gone
+bool writeLine(int fd, const std::string &line);
+
+#endif
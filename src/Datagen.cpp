@@ -0,0 +1,225 @@
+#include "Datagen.h"
+#include "Match.h"
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+PackedPosition packPosition(const Board &board, int score, int result, int ply) {
+    PackedPosition packed = {};
+    int count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = board.squares[sq / 8][sq % 8];
+        if (p == EMPTY) continue;
+        packed.occupancy |= 1ULL << sq;
+        // A legal position has at most 32 pieces; anything beyond is dropped
+        if (count < 32) packed.pieces[count / 2] |= static_cast<uint8_t>(p << (4 * (count & 1)));
+        ++count;
+    }
+    packed.score = static_cast<int16_t>(std::min(std::max(score, -32767), 32767));
+    packed.result = static_cast<int8_t>(result);
+    packed.whiteToMove = board.whiteToMove ? 1 : 0;
+    packed.ply = static_cast<uint16_t>(std::min(ply, 65535));
+    return packed;
+}
+
+Board unpackPosition(const PackedPosition &packed) {
+    Board board;
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) board.squares[r][c] = EMPTY;
+    }
+    int count = 0;
+    for (int sq = 0; sq < 64 && count < 32; ++sq) {
+        if (!(packed.occupancy & (1ULL << sq))) continue;
+        board.squares[sq / 8][sq % 8] = static_cast<Piece>((packed.pieces[count / 2] >> (4 * (count & 1))) & 0xF);
+        ++count;
+    }
+    board.whiteToMove = packed.whiteToMove != 0;
+    return board;
+}
+
+// Shallow searches rarely convert a won ending, so a sustained large score decides the game
+static const int ADJUDICATE_SCORE = 1000;
+static const int ADJUDICATE_PLIES = 8;
+
+namespace {
+
+// Appends finished games to the current chunk, rotating files as they fill
+class ChunkWriter {
+public:
+    explicit ChunkWriter(const DatagenConfig &config) : config(config) {}
+    ~ChunkWriter() { close(); }
+
+    // Returns false once the target is reached (or on a write error)
+    bool append(const std::vector<PackedPosition> &records);
+    uint64_t written() const { return total; }
+
+private:
+    bool open();
+    void close();
+
+    const DatagenConfig &config;
+    std::mutex mutex;
+    FILE    *file = nullptr;
+    int      chunk = 0;
+    uint64_t inChunk = 0;
+    std::atomic<uint64_t> total{0};
+    bool     failed = false;
+};
+
+bool ChunkWriter::open() {
+    char name[32];
+    std::snprintf(name, sizeof(name), "_%04d.bin", chunk++);
+    std::string path = config.output + name;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "datagen: cannot open " << path << "\n";
+        failed = true;
+        return false;
+    }
+    inChunk = 0;
+    return true;
+}
+
+void ChunkWriter::close() {
+    if (file) std::fclose(file);
+    file = nullptr;
+}
+
+bool ChunkWriter::append(const std::vector<PackedPosition> &records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t next = 0;
+    while (next < records.size() && total < config.positions && !failed) {
+        if (!file || inChunk >= config.chunkPositions) {
+            close();
+            if (!open()) break;
+        }
+        uint64_t room = std::min(config.chunkPositions - inChunk, config.positions - total.load());
+        size_t n = static_cast<size_t>(std::min<uint64_t>(room, records.size() - next));
+        if (std::fwrite(&records[next], sizeof(PackedPosition), n, file) != n) {
+            std::cerr << "datagen: write failed\n";
+            failed = true;
+            break;
+        }
+        next += n;
+        inChunk += n;
+        total += n;
+    }
+    if (total >= config.positions) close();
+    return total < config.positions && !failed;
+}
+
+struct DatagenState {
+    std::atomic<uint64_t> nextGame{0};
+    std::atomic<uint64_t> games{0};
+    std::atomic<bool> stop{false};
+};
+
+// Plays one game from opening; returns the result from White's point of view
+static int playGame(const EngineCore &core, SearchContext &context, Board board, int openingPlies,
+                    const DatagenConfig &config, std::vector<PackedPosition> &records) {
+    std::unordered_map<uint64_t, int> seen;
+    int halfmoveClock = 0;
+    int winningPlies = 0;  // Consecutive plies with |score| over ADJUDICATE_SCORE, signed for the winner
+    SearchLimits limits;
+    limits.maxDepth  = config.depth;
+    limits.timeLimit = config.timeLimit;
+    limits.nodeLimit = config.nodeLimit;
+
+    for (int ply = openingPlies;; ++ply) {
+        auto legal = core.generateLegalMoves(board);
+        bool inCheck = core.isKingInCheck(board, board.whiteToMove);
+        if (legal.empty()) {
+            if (inCheck) return board.whiteToMove ? -1 : 1;
+            return 0;
+        }
+        if (++seen[core.computeZobristHash(board)] >= 3) return 0;
+        if (halfmoveClock >= 100)                        return 0;
+        if (insufficientMaterial(board))                 return 0;
+        if (ply >= config.maxPlies)                      return 0;
+
+        Move best = context.findBestMove(board, limits);
+        if (std::find(legal.begin(), legal.end(), best) == legal.end()) best = legal.front();
+        int score = context.getLastStats().score;
+        int whiteScore = board.whiteToMove ? score : -score;
+
+        // Only quiet positions with a non-mate score are useful labels
+        Piece captured = board.squares[best.toRow()][best.toCol()];
+        bool quiet = !inCheck && captured == EMPTY && !best.isPromotion();
+        if (quiet && std::abs(score) < MATE_SCORE - 1000) {
+            records.push_back(packPosition(board, whiteScore, 0, ply));
+        }
+
+        if (whiteScore >= ADJUDICATE_SCORE) {
+            winningPlies = std::max(winningPlies, 0) + 1;
+        } else if (whiteScore <= -ADJUDICATE_SCORE) {
+            winningPlies = std::min(winningPlies, 0) - 1;
+        } else {
+            winningPlies = 0;
+        }
+        if (winningPlies >= ADJUDICATE_PLIES)  return 1;
+        if (winningPlies <= -ADJUDICATE_PLIES) return -1;
+
+        Piece mover = board.squares[best.fromRow()][best.fromCol()];
+        halfmoveClock = (mover == WP || mover == BP || captured != EMPTY) ? 0 : halfmoveClock + 1;
+        core.makeMove(board, best);
+    }
+}
+
+static void datagenThread(const EngineCore &core, const DatagenConfig &config, DatagenState &state,
+                          ChunkWriter &writer) {
+    SearchContext context(core);
+    context.setHashSize(config.hashMb);
+    std::vector<PackedPosition> records;
+
+    while (!state.stop) {
+        uint64_t game = state.nextGame++;
+        // Odd opening lengths give Black the first engine move in half the games
+        int plies = config.openingPlies + static_cast<int>(game & 1);
+        Board board = makeOpening(core, config.seed + game, plies);
+
+        records.clear();
+        int result = playGame(core, context, board, plies, config, records);
+        for (auto &r : records) r.result = static_cast<int8_t>(result);
+        ++state.games;
+        if (!writer.append(records)) state.stop = true;
+    }
+}
+
+} // namespace
+
+int runDatagen(const DatagenConfig &config) {
+    EngineCore core;
+    ChunkWriter writer(config);
+    DatagenState state;
+
+    int threads = config.threads > 0 ? config.threads
+                                     : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(datagenThread, std::cref(core), std::cref(config), std::ref(state), std::ref(writer));
+    }
+
+    // Progress every few seconds until the workers are done
+    std::thread monitor([&]() {
+        while (!state.stop) {
+            for (int i = 0; i < 50 && !state.stop; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cerr << "datagen: " << writer.written() << " positions, " << state.games << " games, "
+                      << static_cast<uint64_t>(writer.written() / std::max(elapsed, 1e-9) * 3600) << " pos/h\n";
+        }
+    });
+    for (auto &t : pool) t.join();
+    monitor.join();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "wrote " << writer.written() << " positions from " << state.games << " games in " << elapsed
+              << " s to " << config.output << "_*.bin" << std::endl;
+    return writer.written() >= config.positions ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include "Engine.h"
+#include <string>
+#include <cstdint>
+
+// One labelled position, 32 bytes, stored little-endian with no padding.
+// Chunk files are plain arrays of these, written and mmapped as-is, so the
+// host byte order is the file byte order; big-endian targets are rejected.
+//
+// occupancy has bit (row * 8 + col) set for every non-empty square; the
+// pieces of those squares follow in the same bit order as 4-bit Piece
+// codes, low nibble first. Score and result are from White's point of view.
+struct PackedPosition {
+    uint64_t occupancy;
+    uint8_t  pieces[16];
+    int16_t  score;        // Search score in centipawns, clamped to int16
+    int8_t   result;       // 1 White won, 0 draw, -1 Black won
+    uint8_t  whiteToMove;  // 1 or 0
+    uint16_t ply;          // Plies since the start position
+    uint16_t reserved;
+};
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay 32 bytes");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "chunk files are written in host byte order");
+
+PackedPosition packPosition(const Board &board, int score, int result, int ply);
+Board unpackPosition(const PackedPosition &packed);
+
+// Self-play data generation. Each thread plays whole games with its own
+// SearchContext; positions of a finished game are labelled with its result
+// and appended to "<output>_NNNN.bin", starting a new chunk every
+// chunkPositions records.
+struct DatagenConfig {
+    std::string output       = "data";
+    uint64_t positions       = 1000000;  // Stop once this many are written
+    int      threads         = 0;        // 0 = one per hardware thread
+    int      depth           = MAX_DEPTH;
+    uint64_t nodeLimit       = 5000;     // Per move; 0 = depth and time only
+    double   timeLimit       = 1.0;      // Per move, a backstop for the node budget
+    int      openingPlies    = 8;        // Random plies before the engine takes over
+    int      maxPlies        = 400;      // Games still running here are drawn
+    uint64_t chunkPositions  = 1 << 20;  // 32 MB chunks
+    size_t   hashMb          = 16;       // Per thread
+    uint64_t seed            = 1;
+};
+
+int runDatagen(const DatagenConfig &config);
+
+#endif
@@ -1,71 +1,26 @@
 #include "Engine.h"
-#include <random>
+#include "Tables.h"
 #include <algorithm>
 #include <cmath>
+#include <cctype>
 
 
-static const int pawnTable[64] = {
-     0,  0,  0,   0,   0,  0,  0,  0,
-     5,  5,  5,  -5,  -5,  0,  5,  5,
-     1,  1,  1,   5,   5,  0,  1,  1,
-     0,  0, 10,  20,  20, 10,  0,  0,
-     5,  5,  5,   5,   5,  5,  5,  5,
-    10, 10, 10,  20,  20, 10, 10, 10,
-    50, 50, 50,  40,  40, 50, 50, 50,
-     0,  0,  0,   0,   0,  0,  0,  0
-};
-
-static const int knightTable[64] = {
-  -50,-40,-30,-30,-30,-30,-40,-50,
-  -40,-20,  0,  5,  5,  0,-20,-40,
-  -30,  5, 10, 15, 15, 10,  5,-30,
-  -30,  0, 15, 20, 20, 15,  0,-30,
-  -30,  5, 15, 20, 20, 15,  5,-30,
-  -30,  0, 10, 15, 15, 10,  0,-30,
-  -40,-20,  0,  0,  0,  0,-20,-40,
-  -50,-40,-30,-30,-30,-30,-40,-50
-};
-
-// Basic piece values
-static const int pieceValue[] = {
-    0,      // EMPTY
-    100,    // WP
-    300,    // WN
-    300,    // WB
-    500,    // WR
-    900,    // WQ
-    99999,  // WK
-   -100,    // BP
-   -300,    // BN
-   -300,    // BB
-   -500,    // BR
-   -900,    // BQ
-   -99999   // BK
-};
-
-ChessEngine::ChessEngine() {
-    initZobristTable();
-}
-
-
-void ChessEngine::initZobristTable() {
-    std::mt19937_64 rng(0xDEADBEAF12345678ULL); 
-    for (int r = 0; r < BOARD_SIZE; r++) {
-        for (int c = 0; c < BOARD_SIZE; c++) {
-            for (int p = 0; p < 14; p++) {
-                zobristTable[r][c][p] = rng();
-            }
-        }
+// Keys, attack masks and evaluation tables are compile-time data (Tables.h)
+EngineCore::EngineCore(size_t sharedHashMb) {
+    if (sharedHashMb > 0) {
+        sharedTT.reset(new TranspositionTable());
+        sharedTT->resize(sharedHashMb);
     }
 }
 
-uint64_t ChessEngine::computeZobristHash(const Board &board) {
+
+uint64_t EngineCore::computeZobristHash(const Board &board) const {
     uint64_t h = 0ULL;
     for (int r = 0; r < BOARD_SIZE; ++r) {
         for (int c = 0; c < BOARD_SIZE; ++c) {
             Piece p = board.squares[r][c];
             if (p != EMPTY) {
-                h ^= zobristTable[r][c][p];
+                h ^= ZOBRIST.keys[r * 8 + c][p];
             }
         }
     }
@@ -77,8 +32,23 @@ uint64_t ChessEngine::computeZobristHash(const Board &board) {
     return h;
 }
 
+// Incremental form of computeZobristHash for the position after move;
+// flipping the side to move is a complement, so the child key is ~(hash ^ delta)
+uint64_t EngineCore::hashAfterMove(const Board &board, uint64_t hash, const Move &move) const {
+    int fr = move.fromRow(), fc = move.fromCol(), tr = move.toRow(), tc = move.toCol();
+    Piece moving   = board.squares[fr][fc];
+    Piece captured = board.squares[tr][tc];
+    Piece placed   = move.isPromotion() ? move.promotion() : moving;
+
+    hash ^= ZOBRIST.keys[fr * 8 + fc][moving] ^ ZOBRIST.keys[tr * 8 + tc][placed];
+    if (captured != EMPTY) {
+        hash ^= ZOBRIST.keys[tr * 8 + tc][captured];
+    }
+    return ~hash;
+}
 
-void ChessEngine::initBoard(Board &board) {
+
+void EngineCore::initBoard(Board &board) const {
     for (int r = 0; r < BOARD_SIZE; ++r) {
         for (int c = 0; c < BOARD_SIZE; ++c) {
             board.squares[r][c] = EMPTY;
@@ -115,16 +85,27 @@ void ChessEngine::initBoard(Board &board) {
 
 
 
-// Directions for sliding pieces
-static const int rookOffsets[4][2]   = {{1,0}, {-1,0}, {0,1}, {0,-1}};
-static const int bishopOffsets[4][2] = {{1,1}, {1,-1}, {-1,1}, {-1,-1}};
-static const int kingOffsets[8][2]   = {{1,0},{1,1},{1,-1},{0,1},{0,-1},{-1,0},{-1,1},{-1,-1}};
-static const int knightOffsets[8][2] = {
-    {-2, -1}, {-2, 1}, {2, -1}, {2, 1},
-    {-1, -2}, {-1, 2}, {1, -2}, {1, 2}
-};
+// Slides along RAYS directions [first, last) until blocked, capturing the other side
+static void addSlides(const Board &board, int r, int c, bool isWhitePiece, int first, int last,
+                      std::vector<Move> &moves) {
+    int from = r * 8 + c;
+    for (int d = first; d < last; ++d) {
+        for (int i = 0; i < RAYS.length[from][d]; ++i) {
+            int to = RAYS.squares[from][d][i];
+            Piece target = board.squares[to / 8][to % 8];
+            if (target == EMPTY) {
+                moves.emplace_back(r, c, to / 8, to % 8);
+                continue;
+            }
+            if (isWhitePiece != (target <= WK)) {
+                moves.emplace_back(r, c, to / 8, to % 8);
+            }
+            break; // cannot jump
+        }
+    }
+}
 
-std::vector<Move> ChessEngine::generatePseudoLegalMoves(const Board &board) {
+std::vector<Move> EngineCore::generatePseudoLegalMoves(const Board &board) const {
     std::vector<Move> moves;
 
     for (int r = 0; r < BOARD_SIZE; ++r) {
@@ -210,133 +191,28 @@ std::vector<Move> ChessEngine::generatePseudoLegalMoves(const Board &board) {
                 } break;
 
                 
-                case WN: case BN: {
-                    for (auto &offset : knightOffsets) {
-                        int rr = r + offset[0];
-                        int cc = c + offset[1];
-                        if (rr >= 0 && rr < 8 && cc >= 0 && cc < 8) {
-                            Piece target = board.squares[rr][cc];
-                            if (isWhitePiece) {
-                                if (target == EMPTY || (target >= BP && target <= BK)) {
-                                    moves.emplace_back(r, c, rr, cc);
-                                }
-                            } else {
-                                if (target == EMPTY || (target >= WP && target <= WK)) {
-                                    moves.emplace_back(r, c, rr, cc);
-                                }
-                            }
-                        }
-                    }
-                } break;
+                case WN: case BN:
                 case WK: case BK: {
-                    for (auto &offset : kingOffsets) {
-                        int rr = r + offset[0];
-                        int cc = c + offset[1];
-                        if (rr >= 0 && rr < 8 && cc >= 0 && cc < 8) {
-                            Piece target = board.squares[rr][cc];
-                            if (isWhitePiece) {
-                                if (target == EMPTY || (target >= BP && target <= BK)) {
-                                    moves.emplace_back(r, c, rr, cc);
-                                }
-                            } else {
-                                if (target == EMPTY || (target >= WP && target <= WK)) {
-                                    moves.emplace_back(r, c, rr, cc);
-                                }
-                            }
+                    bool knight = (piece == WN || piece == BN);
+                    uint64_t targets = knight ? ATTACKS.knight[r * 8 + c] : ATTACKS.king[r * 8 + c];
+                    for (; targets; targets &= targets - 1) {
+                        int to = __builtin_ctzll(targets);
+                        Piece target = board.squares[to / 8][to % 8];
+                        if (target == EMPTY || isWhitePiece != (target <= WK)) {
+                            moves.emplace_back(r, c, to / 8, to % 8);
                         }
                     }
-                    
                 } break;
 
-                
-                case WR: case BR: {
-                    int steps = 4; // rook offsets
-                    for (int i = 0; i < steps; ++i) {
-                        int rr = r, cc = c;
-                        while (true) {
-                            rr += rookOffsets[i][0];
-                            cc += rookOffsets[i][1];
-                            if (rr < 0 || rr >= 8 || cc < 0 || cc >= 8) break;
-                            Piece target = board.squares[rr][cc];
-                            if (target == EMPTY) {
-                                moves.emplace_back(r,c, rr,cc);
-                            } else {
-                                bool isOppositeColor = (isWhitePiece && target >= BP && target <= BK)
-                                                   || (!isWhitePiece && target >= WP && target <= WK);
-                                if (isOppositeColor) {
-                                    moves.emplace_back(r,c, rr,cc);
-                                }
-                                break; // cannot jump
-                            }
-                        }
-                    }
-                } break;
-                case WB: case BB: {
-                    int steps = 4; // bishop offsets
-                    for (int i = 0; i < steps; ++i) {
-                        int rr = r, cc = c;
-                        while (true) {
-                            rr += bishopOffsets[i][0];
-                            cc += bishopOffsets[i][1];
-                            if (rr < 0 || rr >= 8 || cc < 0 || cc >= 8) break;
-                            Piece target = board.squares[rr][cc];
-                            if (target == EMPTY) {
-                                moves.emplace_back(r,c, rr,cc);
-                            } else {
-                                bool isOppositeColor = (isWhitePiece && target >= BP && target <= BK)
-                                                   || (!isWhitePiece && target >= WP && target <= WK);
-                                if (isOppositeColor) {
-                                    moves.emplace_back(r,c, rr,cc);
-                                }
-                                break;
-                            }
-                        }
-                    }
-                } break;
-                case WQ: case BQ: {
-                    
-                    int steps = 4;
-                    // Rook-like
-                    for (int i = 0; i < steps; ++i) {
-                        int rr = r, cc = c;
-                        while (true) {
-                            rr += rookOffsets[i][0];
-                            cc += rookOffsets[i][1];
-                            if (rr < 0 || rr >= 8 || cc < 0 || cc >= 8) break;
-                            Piece target = board.squares[rr][cc];
-                            if (target == EMPTY) {
-                                moves.emplace_back(r,c, rr,cc);
-                            } else {
-                                bool isOppositeColor = (isWhitePiece && target >= BP && target <= BK)
-                                                   || (!isWhitePiece && target >= WP && target <= WK);
-                                if (isOppositeColor) {
-                                    moves.emplace_back(r,c, rr,cc);
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    // Bishop-like
-                    for (int i = 0; i < steps; ++i) {
-                        int rr = r, cc = c;
-                        while (true) {
-                            rr += bishopOffsets[i][0];
-                            cc += bishopOffsets[i][1];
-                            if (rr < 0 || rr >= 8 || cc < 0 || cc >= 8) break;
-                            Piece target = board.squares[rr][cc];
-                            if (target == EMPTY) {
-                                moves.emplace_back(r,c, rr,cc);
-                            } else {
-                                bool isOppositeColor = (isWhitePiece && target >= BP && target <= BK)
-                                                   || (!isWhitePiece && target >= WP && target <= WK);
-                                if (isOppositeColor) {
-                                    moves.emplace_back(r,c, rr,cc);
-                                }
-                                break;
-                            }
-                        }
-                    }
-                } break;
+                case WR: case BR:
+                    addSlides(board, r, c, isWhitePiece, 0, 4, moves);
+                    break;
+                case WB: case BB:
+                    addSlides(board, r, c, isWhitePiece, 4, 8, moves);
+                    break;
+                case WQ: case BQ:
+                    addSlides(board, r, c, isWhitePiece, 0, 8, moves);
+                    break;
                 default: break;
             }
         }
@@ -345,13 +221,13 @@ std::vector<Move> ChessEngine::generatePseudoLegalMoves(const Board &board) {
 }
 
 
-std::vector<Move> ChessEngine::generateLegalMoves(const Board &board) {
+std::vector<Move> EngineCore::generateLegalMoves(const Board &board) const {
     std::vector<Move> pseudo = generatePseudoLegalMoves(board);
     std::vector<Move> legal;
     // For each move, make it, check if king is in check
     for (auto &m : pseudo) {
         Board copy = board;
-        Piece captured = copy.squares[m.toRow][m.toCol];
+        Piece captured = copy.squares[m.toRow()][m.toCol()];
         makeMove(copy, m);
         
         bool whiteKing = copy.whiteToMove ? false : true; 
@@ -363,7 +239,7 @@ std::vector<Move> ChessEngine::generateLegalMoves(const Board &board) {
 }
 
 
-bool ChessEngine::isKingInCheck(const Board &board, bool whiteKing) {
+bool EngineCore::isKingInCheck(const Board &board, bool whiteKing) const {
     
     Piece kingPiece = whiteKing ? WK : BK;
     int kingR = -1, kingC = -1;
@@ -381,46 +257,69 @@ bool ChessEngine::isKingInCheck(const Board &board, bool whiteKing) {
         return true;
     }
 
-   
-    bool enemySideIsWhite = !whiteKing;
-    
-    Board temp = board;
-    temp.whiteToMove = enemySideIsWhite; 
-    auto enemyMoves = generatePseudoLegalMoves(temp);
-    for (auto &mv : enemyMoves) {
-        if (mv.toRow == kingR && mv.toCol == kingC) {
-            return true;
+    // Look outward from the king instead of generating the enemy's moves
+    int kingSq = kingR * 8 + kingC;
+    Piece pawn   = whiteKing ? BP : WP;
+    Piece knight = whiteKing ? BN : WN;
+    Piece bishop = whiteKing ? BB : WB;
+    Piece rook   = whiteKing ? BR : WR;
+    Piece queen  = whiteKing ? BQ : WQ;
+    Piece king   = whiteKing ? BK : WK;
+
+    auto attackedFrom = [&](uint64_t squares, Piece attacker) {
+        for (; squares; squares &= squares - 1) {
+            int sq = __builtin_ctzll(squares);
+            if (board.squares[sq / 8][sq % 8] == attacker) return true;
+        }
+        return false;
+    };
+    // An enemy pawn attacks the king from where a friendly pawn on the king's square would capture
+    if (attackedFrom(ATTACKS.pawn[whiteKing ? 0 : 1][kingSq], pawn)) return true;
+    if (attackedFrom(ATTACKS.knight[kingSq], knight)) return true;
+    if (attackedFrom(ATTACKS.king[kingSq], king)) return true;
+
+    for (int d = 0; d < RAY_DIRECTIONS; ++d) {
+        Piece slider = (d < 4) ? rook : bishop;
+        for (int i = 0; i < RAYS.length[kingSq][d]; ++i) {
+            int sq = RAYS.squares[kingSq][d][i];
+            Piece p = board.squares[sq / 8][sq % 8];
+            if (p == EMPTY) continue;
+            if (p == slider || p == queen) return true;
+            break;
         }
     }
     return false;
 }
 
 
-void ChessEngine::makeMove(Board &board, const Move &move) {
-    Piece movingPiece = board.squares[move.fromRow][move.fromCol];
-    Piece capturedPiece = board.squares[move.toRow][move.toCol];
+void EngineCore::makeMove(Board &board, const Move &move) const {
+    Piece movingPiece = board.squares[move.fromRow()][move.fromCol()];
+    Piece capturedPiece = board.squares[move.toRow()][move.toCol()];
 
-    board.squares[move.toRow][move.toCol] = movingPiece;
-    board.squares[move.fromRow][move.fromCol] = EMPTY;
+    board.squares[move.toRow()][move.toCol()] = movingPiece;
+    board.squares[move.fromRow()][move.fromCol()] = EMPTY;
 
     // Handle promotion
-    if (move.promotion != EMPTY) {
-        board.squares[move.toRow][move.toCol] = move.promotion;
+    if (move.isPromotion()) {
+        board.squares[move.toRow()][move.toCol()] = move.promotion();
     }
 
     // Switch side
     board.whiteToMove = !board.whiteToMove;
 }
 
-void ChessEngine::undoMove(Board &board, const Move &move, Piece captured) {
-    Piece movingPiece = board.squares[move.toRow][move.toCol];
-    board.squares[move.fromRow][move.fromCol] = movingPiece;
-    board.squares[move.toRow][move.toCol] = captured;
+void EngineCore::undoMove(Board &board, const Move &move, Piece captured) const {
+    Piece movingPiece = board.squares[move.toRow()][move.toCol()];
+    if (move.isPromotion()) {
+        movingPiece = (move.toRow() == 7) ? WP : BP;
+    }
+    board.squares[move.fromRow()][move.fromCol()] = movingPiece;
+    board.squares[move.toRow()][move.toCol()] = captured;
     board.whiteToMove = !board.whiteToMove;
 }
 
 
-int ChessEngine::evaluate(const Board &board) {
+int EngineCore::evaluate(const Board &board) const {
     
 
     int score = 0;
@@ -428,44 +327,10 @@ int ChessEngine::evaluate(const Board &board) {
         for (int c = 0; c < 8; ++c) {
             Piece p = board.squares[r][c];
             if (p == EMPTY) continue;
-
-            int idx64 = r*8 + c; 
-
-            int val = pieceValue[p];
-            switch (p) {
-                case WP:
-                    val += pawnTable[idx64];
-                    break;
-                case WN:
-                    val += knightTable[idx64];
-                    break;
-                case WB:
-                    
-                    break;
-                case WQ:
-                    
-                    break;
-                case WR:
-                    
-                    break;
-                case WK:
-                    
-                    break;
-                case BP:
-                    
-                    break;
-                case BN:
-                    
-                    break;
-                
-                default: break;
-            }
-
-            score += val;
+            score += PIECE_SQUARE.value[p][r * 8 + c];
         }
     }
 
-    
     if (!board.whiteToMove) {
         score = -score;
     }
@@ -473,201 +338,6 @@ int ChessEngine::evaluate(const Board &board) {
 }
 
 
-int ChessEngine::quiescenceSearch(Board &board, int alpha, int beta) {
-    // Evaluate current position
-    int standPat = evaluate(board);
-    if (standPat >= beta) {
-        return beta;
-    }
-    if (standPat > alpha) {
-        alpha = standPat;
-    }
-
-    
-    std::vector<Move> moves;
-    {
-        auto pseudo = generatePseudoLegalMoves(board);
-        
-        for (auto &m: pseudo) {
-            if (board.squares[m.toRow][m.toCol] != EMPTY) {
-                moves.push_back(m);
-            }
-        }
-    }
-
-    
-    sortMoves(board, moves);
-
-    for (auto &m : moves) {
-        Piece captured = board.squares[m.toRow][m.toCol];
-        makeMove(board, m);
-        if (!isKingInCheck(board, board.whiteToMove ? false : true)) {
-            int score = -quiescenceSearch(board, -beta, -alpha);
-            undoMove(board, m, captured);
-
-            if (score >= beta) {
-                return beta;
-            }
-            if (score > alpha) {
-                alpha = score;
-            }
-        } else {
-            undoMove(board, m, captured);
-        }
-    }
-    return alpha;
-}
-
-
-int ChessEngine::alphaBeta(Board &board, int alpha, int beta, int depth, bool doNullMove) {
-    
-    if (timeIsUp()) {
-        return evaluate(board);
-    }
-
-    if (depth == 0) {
-        
-        return quiescenceSearch(board, alpha, beta);
-    }
-
-    uint64_t hash = computeZobristHash(board);
-    TTKey key{hash, depth};
-
-    
-    auto it = tTable.find(key);
-    if (it != tTable.end()) {
-        TTEntry &entry = it->second;
-        if (entry.depth >= depth) {
-            if (entry.flag == 0)  return entry.score;       
-            if (entry.flag == -1) alpha = std::max(alpha, entry.score); 
-            if (entry.flag ==  1) beta  = std::min(beta,  entry.score); 
-            if (alpha >= beta) {
-                return entry.score;
-            }
-        }
-    }
-
-    // Generate legal moves
-    std::vector<Move> moves = generateLegalMoves(board);
-    if (moves.empty()) {
-        // no moves => checkmate or stalemate
-        if (isKingInCheck(board, !board.whiteToMove)) {
-            // checkmate
-            return -MATE_SCORE + (MAX_DEPTH - depth);
-        } else {
-            // stalemate
-            return 0;
-        }
-    }
-
-    // Move ordering
-    sortMoves(board, moves);
-
-    bool isPV = false;
-    int bestValue = -INFINITY_SCORE;
-    for (auto &m : moves) {
-        Piece captured = board.squares[m.toRow][m.toCol];
-        makeMove(board, m);
-        int score = -alphaBeta(board, -beta, -alpha, depth - 1);
-        undoMove(board, m, captured);
-
-        if (score > bestValue) {
-            bestValue = score;
-            if (score > alpha) {
-                alpha = score;
-                isPV = true;
-                if (alpha >= beta) {
-                    break; 
-                }
-            }
-        }
-    }
-
-    
-    TTEntry newEntry;
-    newEntry.score = bestValue;
-    newEntry.depth = depth;
-    if (bestValue <= alpha) {
-       
-        if (bestValue <= alpha) newEntry.flag = -1; // alpha
-        if (bestValue >= beta)  newEntry.flag =  1; // beta
-        if (bestValue > alpha && bestValue < beta) newEntry.flag = 0; // exact
-    }
-    else {
-        
-        if (bestValue <= alpha) newEntry.flag = -1;
-        else if (bestValue >= beta) newEntry.flag = 1;
-        else newEntry.flag = 0;
-    }
-    tTable[key] = newEntry;
-
-    return bestValue;
-}
-
-// Search from root to get best move
-int ChessEngine::searchRoot(Board &board, int depth, Move &bestMove) {
-    int alpha = -INFINITY_SCORE;
-    int beta  =  INFINITY_SCORE;
-
-    int bestScore = -INFINITY_SCORE;
-    auto moves = generateLegalMoves(board);
-
-    // Move ordering
-    sortMoves(board, moves);
-
-    bool foundMove = false;
-    for (auto &m : moves) {
-        Piece captured = board.squares[m.toRow][m.toCol];
-        makeMove(board, m);
-        int score = -alphaBeta(board, -beta, -alpha, depth - 1);
-        undoMove(board, m, captured);
-
-        if (score > bestScore) {
-            bestScore = score;
-            bestMove = m;
-            foundMove = true;
-            if (score > alpha) {
-                alpha = score;
-                if (alpha >= beta) {
-                    break; // cutoff
-                }
-            }
-        }
-        if (timeIsUp()) break;
-    }
-    
-    return bestScore;
-}
-
-
-Move ChessEngine::findBestMove(Board &board, int maxDepth, double timeLimit) {
-    timeLimitSec = timeLimit;
-    startTime = std::chrono::steady_clock::now();
-
-    Move bestMove;
-    // Iterative deepening
-    for (int depth = 1; depth <= maxDepth; ++depth) {
-        if (timeIsUp()) break; 
-        Move localBest;
-        int score = searchRoot(board, depth, localBest);
-        if (!timeIsUp()) {
-            bestMove = localBest; 
-        } 
-        else {
-            break; 
-        }
-    }
-    return bestMove;
-}
-
-
-bool ChessEngine::timeIsUp() {
-    auto now = std::chrono::steady_clock::now();
-    double elapsed = std::chrono::duration<double>(now - startTime).count();
-    return (elapsed >= timeLimitSec);
-}
-
-
 static int mvvLvaScore(Piece attacker, Piece victim) {
     // "Most valuable victim, least valuable attacker"
     // Higher = higher priority
@@ -676,13 +346,13 @@ static int mvvLvaScore(Piece attacker, Piece victim) {
     return 10 * victimVal - attackerVal; 
 }
 
-void ChessEngine::sortMoves(Board &board, std::vector<Move> &moves) {
+void EngineCore::sortMoves(const Board &board, std::vector<Move> &moves) const {
     // Sort captures first by MVV-LVA, then non-captures
     std::sort(moves.begin(), moves.end(), [&](const Move &a, const Move &b){
-        Piece aAtt = board.squares[a.fromRow][a.fromCol];
-        Piece aVic = board.squares[a.toRow][a.toCol];
-        Piece bAtt = board.squares[b.fromRow][b.fromCol];
-        Piece bVic = board.squares[b.toRow][b.toCol];
+        Piece aAtt = board.squares[a.fromRow()][a.fromCol()];
+        Piece aVic = board.squares[a.toRow()][a.toCol()];
+        Piece bAtt = board.squares[b.fromRow()][b.fromCol()];
+        Piece bVic = board.squares[b.toRow()][b.toCol()];
 
         bool aIsCapture = (aVic != EMPTY);
         bool bIsCapture = (bVic != EMPTY);
@@ -699,3 +369,75 @@ void ChessEngine::sortMoves(Board &board, std::vector<Move> &moves) {
         return false;
     });
 }
+
+
+
+static const char fenPieceChars[] = " PNBRQKpnbrqk";
+
+std::string boardToFen(const Board &board) {
+    std::string fen;
+    for (int r = BOARD_SIZE - 1; r >= 0; --r) {
+        int empty = 0;
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            Piece p = board.squares[r][c];
+            if (p == EMPTY) {
+                ++empty;
+                continue;
+            }
+            if (empty) {
+                fen += char('0' + empty);
+                empty = 0;
+            }
+            fen += fenPieceChars[p];
+        }
+        if (empty) fen += char('0' + empty);
+        if (r > 0) fen += '/';
+    }
+    fen += board.whiteToMove ? " w" : " b";
+    return fen;
+}
+
+bool boardFromFen(const std::string &fen, Board &board) {
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            board.squares[r][c] = EMPTY;
+        }
+    }
+
+    size_t i = 0;
+    int r = BOARD_SIZE - 1, c = 0;
+    for (; i < fen.size() && fen[i] != ' '; ++i) {
+        char ch = fen[i];
+        if (ch == '/') {
+            if (c != BOARD_SIZE || r == 0) return false;
+            --r;
+            c = 0;
+        } else if (ch >= '1' && ch <= '8') {
+            c += ch - '0';
+            if (c > BOARD_SIZE) return false;
+        } else {
+            const char *pos = std::char_traits<char>::find(fenPieceChars + 1, 12, ch);
+            if (!pos || c >= BOARD_SIZE) return false;
+            board.squares[r][c++] = static_cast<Piece>(pos - fenPieceChars);
+        }
+    }
+    if (r != 0 || c != BOARD_SIZE) return false;
+
+    // Side to move; remaining fields (castling, en passant, clocks) are ignored
+    while (i < fen.size() && fen[i] == ' ') ++i;
+    if (i >= fen.size() || (fen[i] != 'w' && fen[i] != 'b')) return false;
+    board.whiteToMove = (fen[i] == 'w');
+    return true;
+}
+
+std::string moveToString(const Move &move) {
+    std::string s;
+    s += char('a' + move.fromCol());
+    s += char('1' + move.fromRow());
+    s += char('a' + move.toCol());
+    s += char('1' + move.toRow());
+    if (move.promotion() != EMPTY) {
+        s += static_cast<char>(std::tolower(fenPieceChars[move.promotion()]));
+    }
+    return s;
+}
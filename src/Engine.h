@@ -5,9 +5,14 @@
 #include <string>
 #include <iostream>
 #include <limits>
-#include <unordered_map>
 #include <cstdint>
 #include <chrono>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "TT.h"
 
 constexpr int BOARD_SIZE     = 8;
 constexpr int MAX_DEPTH      = 6;           // Default max depth for iterative deepening
@@ -15,6 +20,11 @@ constexpr int MATE_SCORE     = 100000;
 constexpr int INFINITY_SCORE = 100000000;
 constexpr int QSEARCH_DEPTH  = 4;           // Depth limit for quiescence search 
 constexpr double DEFAULT_TIME_LIMIT = 5.0;  // 5 seconds as an example
+constexpr size_t DEFAULT_HASH_MB    = 64;   // Transposition table size for long-lived searchers
+constexpr size_t CONTEXT_HASH_MB    = 2;    // Private table of a context nobody sized; cheap to spin up
+
+// Score of a side that is mated with depth plies of search remaining, as alphaBeta returns it
+constexpr int matedScore(int depth) { return -MATE_SCORE + (MAX_DEPTH - depth); }
 
 // Piece Encoding
 enum Piece {
@@ -40,88 +50,229 @@ struct Board {
    
 };
 
-// Basic Move
+// Packed 16-bit move: bits 0-5 from-square, 6-11 to-square, 12-15 flags.
+// Squares are row * 8 + col. The promotion piece's colour follows from the
+// destination rank, so the flags only carry its type.
+enum MoveFlag : uint16_t {
+    MOVE_NORMAL     = 0,
+    MOVE_PROMO_N    = 1,
+    MOVE_PROMO_B    = 2,
+    MOVE_PROMO_R    = 3,
+    MOVE_PROMO_Q    = 4,
+    MOVE_CASTLE     = 5,   // Reserved; castling is not generated yet
+    MOVE_EN_PASSANT = 6    // Reserved; en passant is not generated yet
+};
+
 struct Move {
-    int fromRow, fromCol;
-    int toRow, toCol;
-    Piece promotion; // For pawn promotion, or EMPTY if none.
+    uint16_t data;
 
+    Move() : data(0) {}
+    explicit Move(uint16_t packed) : data(packed) {}
     Move(int fr, int fc, int tr, int tc, Piece prom = EMPTY)
-        : fromRow(fr), fromCol(fc), toRow(tr), toCol(tc), promotion(prom) {}
-    Move() : fromRow(0), fromCol(0), toRow(0), toCol(0), promotion(EMPTY) {}
-};
+        : data(static_cast<uint16_t>((fr * 8 + fc) | ((tr * 8 + tc) << 6) | (promoFlag(prom) << 12))) {}
 
-// Transposition Table Key and Entry
-struct TTKey {
-    uint64_t positionKey;
-    int depth;
+    int from() const     { return data & 63; }
+    int to() const       { return (data >> 6) & 63; }
+    int flags() const    { return data >> 12; }
+    int fromRow() const  { return from() >> 3; }
+    int fromCol() const  { return from() & 7; }
+    int toRow() const    { return to() >> 3; }
+    int toCol() const    { return to() & 7; }
+
+    bool isPromotion() const { return flags() >= MOVE_PROMO_N && flags() <= MOVE_PROMO_Q; }
+
+    // For pawn promotion, or EMPTY if none.
+    Piece promotion() const {
+        if (!isPromotion()) return EMPTY;
+        // N, B, R, Q flags map onto WN..WQ; promotions onto rank 1 are Black's
+        int white = WN + flags() - MOVE_PROMO_N;
+        return static_cast<Piece>(toRow() == 0 ? white + (BP - WP) : white);
+    }
+
+    bool operator==(const Move &o) const { return data == o.data; }
+    bool operator!=(const Move &o) const { return data != o.data; }
+
+private:
+    static int promoFlag(Piece prom) {
+        switch (prom) {
+            case WN: case BN: return MOVE_PROMO_N;
+            case WB: case BB: return MOVE_PROMO_B;
+            case WR: case BR: return MOVE_PROMO_R;
+            case WQ: case BQ: return MOVE_PROMO_Q;
+            default:          return MOVE_NORMAL;
+        }
+    }
 };
+static_assert(sizeof(Move) == 2, "Move must stay packed into 16 bits");
 
-struct TTEntry {
+// Summary of the last completed iteration of findBestMove
+struct SearchStats {
     int score;
-    int flag; 
     int depth;
+    uint64_t nodes;
+    double elapsedSec;
 };
 
-struct TTKeyHash {
-    std::size_t operator()(const TTKey &k) const {
-       
-        auto h1 = std::hash<uint64_t>()(k.positionKey);
-        auto h2 = std::hash<int>()(k.depth);
-        return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
-    }
+struct SearchLimits {
+    int      maxDepth  = MAX_DEPTH;
+    double   timeLimit = DEFAULT_TIME_LIMIT;
+    uint64_t nodeLimit = 0;  // 0 means no node budget
+    int      multiPV   = 1;  // Ranked root moves searched per iteration
 };
 
-struct TTKeyEqual {
-    bool operator()(const TTKey &a, const TTKey &b) const {
-        return (a.positionKey == b.positionKey && a.depth == b.depth);
-    }
+// One ranked root move; pv starts with move and is read back from the TT
+struct PVLine {
+    Move move;
+    int score;
+    std::vector<Move> pv;
 };
 
-class ChessEngine {
+// Called after every completed iteration of a search; getLastLines() already holds its lines
+using ProgressCallback = std::function<void(const SearchStats &stats, const Move &bestMove)>;
+
+// Read-only state shared by every search: move generation, evaluation and,
+// optionally, one transposition table for all contexts. Zobrist keys and
+// the other lookup tables are compile-time data (Tables.h), so a core
+// without a shared table costs nothing to construct and any number of
+// threads can use one.
+class EngineCore {
 public:
-    ChessEngine();
+    // sharedHashMb > 0 allocates a table shared by every SearchContext on this core
+    explicit EngineCore(size_t sharedHashMb = 0);
 
     // Board initialization
-    void initBoard(Board &board);
+    void initBoard(Board &board) const;
 
-    // Search interface
-    Move findBestMove(Board &board, int maxDepth = MAX_DEPTH, double timeLimit = DEFAULT_TIME_LIMIT);
+    // Move generation and make/unmake
+    std::vector<Move> generatePseudoLegalMoves(const Board &board) const;
+    std::vector<Move> generateLegalMoves(const Board &board) const;
+    bool isKingInCheck(const Board &board, bool whiteKing) const;
+    void makeMove(Board &board, const Move &move) const;
+    void undoMove(Board &board, const Move &move, Piece captured) const;
+
+    int evaluate(const Board &board) const;
+    void sortMoves(const Board &board, std::vector<Move> &moves) const;
+
+    uint64_t computeZobristHash(const Board &board) const;
+    uint64_t hashAfterMove(const Board &board, uint64_t hash, const Move &move) const;
+
+    TranspositionTable *sharedTable() const { return sharedTT.get(); }
 
 private:
-    
-    std::vector<Move> generatePseudoLegalMoves(const Board &board);
-    bool isKingInCheck(const Board &board, bool whiteKing);
-    std::vector<Move> generateLegalMoves(const Board &board);
+    std::unique_ptr<TranspositionTable> sharedTT;
+};
+
+// Per-search state. A context runs one search at a time, either blocking on
+// the caller's thread or asynchronously on its own thread; any number of
+// contexts may search concurrently against one EngineCore.
+class SearchContext {
+public:
+    explicit SearchContext(const EngineCore &core);
+    ~SearchContext();
+    SearchContext(const SearchContext &) = delete;
+    SearchContext &operator=(const SearchContext &) = delete;
 
-    
-    void makeMove(Board &board, const Move &move);
-    void undoMove(Board &board, const Move &move, Piece captured);
+    // Blocking search; board is restored before returning
+    Move findBestMove(Board &board, const SearchLimits &limits, const ProgressCallback &progress = nullptr);
 
-    
-    int evaluate(const Board &board);
+    // Asynchronous search on a private copy of board
+    void startSearch(const Board &board, const SearchLimits &limits, ProgressCallback progress = nullptr);
+    // The running search, blocking or asynchronous, returns its last completed
+    // iteration; on an idle context stop() has no effect on later searches
+    void stop();
+    Move wait();   // Joins the search started by startSearch and returns its move
 
-    
-    int alphaBeta(Board &board, int alpha, int beta, int depth, bool doNullMove = true);
-    int quiescenceSearch(Board &board, int alpha, int beta);
-    
-    
-    int searchRoot(Board &board, int depth, Move &bestMove);
+    // Valid once the search has finished
+    const SearchStats &getLastStats() const { return lastStats; }
+    const std::vector<PVLine> &getLastLines() const { return lastLines; }  // Best first, multiPV long
+
+    // Private table size (CONTEXT_HASH_MB unless set), allocated on the first search;
+    // unused when the core shares a table
+    void setHashSize(size_t megabytes);
 
-    
-    uint64_t computeZobristHash(const Board &board);
-    void initZobristTable();
+private:
+    int alphaBeta(Board &board, uint64_t hash, int alpha, int beta, int depth, bool doNullMove = true);
+    int quiescenceSearch(Board &board, int alpha, int beta);
+    Move runSearch(Board &board, const SearchLimits &limits, const ProgressCallback &progress);
+    int searchRoot(Board &board, uint64_t hash, int depth, const std::vector<Move> &moves, size_t slots, int floor,
+                   std::vector<PVLine> &lines);
+    std::vector<Move> extractPV(Board board, uint64_t hash, const Move &first, int maxLength) const;
+    bool timeIsUp();
 
-    std::unordered_map<TTKey, TTEntry, TTKeyHash, TTKeyEqual> tTable;
-    uint64_t zobristTable[BOARD_SIZE][BOARD_SIZE][14]; 
+    const EngineCore &core;
+    TranspositionTable ownTable;
+    TranspositionTable *tTable;
+    size_t hashMb;
 
-    
     std::chrono::steady_clock::time_point startTime;
     double timeLimitSec;
-    bool timeIsUp();
+    uint64_t nodeLimit;
+    std::atomic<bool> stopRequested;
+    bool aborted;  // A limit was hit during this search; partial scores must not be used or stored
+
+    uint64_t nodes;
+    SearchStats lastStats;
+    std::vector<PVLine> lastLines;
+
+    // Asynchronous search
+    std::thread searchThread;
+    Board asyncBoard;
+    Move asyncResult;
+};
+
+// Reuses SearchContexts (and their private tables) across requests.
+// A lease returns its context to the pool when it goes out of scope.
+// Contexts search the core's shared table when it has one; otherwise each
+// gets a private table of hashMbPerContext.
+class ContextPool {
+public:
+    using Lease = std::unique_ptr<SearchContext, std::function<void(SearchContext *)>>;
+
+    explicit ContextPool(const EngineCore &core, size_t hashMbPerContext = CONTEXT_HASH_MB);
+
+    Lease acquire();
+    size_t idle() const;
+
+private:
+    const EngineCore &core;
+    size_t hashMb;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<SearchContext>> freeContexts;
+};
+
+// Single-owner engine: one core plus one context, for callers that do not share
+class ChessEngine {
+public:
+    ChessEngine() : context(core) {}
 
-    
-    void sortMoves(Board &board, std::vector<Move> &moves);
+    // Board initialization
+    void initBoard(Board &board) const { core.initBoard(board); }
+
+    // Search interface
+    // nodeLimit of 0 means no node budget
+    Move findBestMove(Board &board, int maxDepth = MAX_DEPTH, double timeLimit = DEFAULT_TIME_LIMIT,
+                      uint64_t nodeLimit = 0) {
+        return context.findBestMove(board, SearchLimits{maxDepth, timeLimit, nodeLimit});
+    }
+    const SearchStats &getLastStats() const { return context.getLastStats(); }
+
+    // Transposition table size; allocated on the first search
+    void setHashSize(size_t megabytes) { context.setHashSize(megabytes); }
+
+    // Move generation and make/unmake, used by drivers that split work at the root
+    std::vector<Move> generateLegalMoves(const Board &board) const { return core.generateLegalMoves(board); }
+    bool isKingInCheck(const Board &board, bool whiteKing) const { return core.isKingInCheck(board, whiteKing); }
+    void makeMove(Board &board, const Move &move) const { core.makeMove(board, move); }
+    void undoMove(Board &board, const Move &move, Piece captured) const { core.undoMove(board, move, captured); }
+
+private:
+    EngineCore core;
+    SearchContext context;
 };
 
+// Text I/O: FEN (piece placement and side to move) and coordinate move notation
+std::string boardToFen(const Board &board);
+bool boardFromFen(const std::string &fen, Board &board);
+std::string moveToString(const Move &move);
+
 #endif
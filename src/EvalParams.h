@@ -0,0 +1,46 @@
+// Evaluation weights read by EngineCore::evaluate.
+// Regenerate with: engine --tune DATASET --out src/EvalParams.h
+#ifndef EVAL_PARAMS_H
+#define EVAL_PARAMS_H
+
+// Piece-square tables from White's side, a1 first; Black reads them mirrored
+static constexpr int pawnTable[64] = {
+     0,  0,  0,   0,   0,  0,  0,  0,
+     5,  5,  5,  -5,  -5,  0,  5,  5,
+     1,  1,  1,   5,   5,  0,  1,  1,
+     0,  0, 10,  20,  20, 10,  0,  0,
+     5,  5,  5,   5,   5,  5,  5,  5,
+    10, 10, 10,  20,  20, 10, 10, 10,
+    50, 50, 50,  40,  40, 50, 50, 50,
+     0,  0,  0,   0,   0,  0,  0,  0
+};
+
+static constexpr int knightTable[64] = {
+  -50,-40,-30,-30,-30,-30,-40,-50,
+  -40,-20,  0,  5,  5,  0,-20,-40,
+  -30,  5, 10, 15, 15, 10,  5,-30,
+  -30,  0, 15, 20, 20, 15,  0,-30,
+  -30,  5, 15, 20, 20, 15,  5,-30,
+  -30,  0, 10, 15, 15, 10,  0,-30,
+  -40,-20,  0,  0,  0,  0,-20,-40,
+  -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+// Basic piece values
+static constexpr int pieceValue[] = {
+    0,      // EMPTY
+    100,    // WP
+    300,    // WN
+    300,    // WB
+    500,    // WR
+    900,    // WQ
+    99999,  // WK
+   -100,    // BP
+   -300,    // BN
+   -300,    // BB
+   -500,    // BR
+   -900,    // BQ
+   -99999   // BK
+};
+
+#endif
@@ -1,30 +1,59 @@
 #include "Engine.h"
+#include "Cluster.h"
+#include "Match.h"
+#include "Tuner.h"
+#include "Datagen.h"
+#include "Perft.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
 
-int main() {
+static void printUsage() {
+    std::cerr << "usage: engine                                  run the demo\n"
+              << "       engine --coordinator ADDR [options]     analyze FEN lines from stdin on workers\n"
+              << "       engine --worker ADDR                    serve analysis jobs\n"
+              << "       engine --match ENGINE_A ENGINE_B [options]  play A against B and run an SPRT\n"
+              << "       engine --tune DATASET [options]         fit EvalParams.h to FEN/result lines\n"
+              << "       engine --analyze [options]              print ranked lines for FEN lines from stdin\n"
+              << "       engine --datagen PREFIX [options]       write self-play positions to PREFIX_NNNN.bin\n"
+              << "       engine --perft [options]                check move generation against known counts\n"
+              << "cluster options: --workers N  --depth D  --time SEC  --nodes N  --split  --heartbeat MS\n"
+              << "                 --hash MB  --timeout MS  --queue N\n"
+              << "match options:   --games N  --concurrency N  --depth D  --time SEC  --nodes N  --plies N\n"
+              << "                 --max-plies N  --seed N  --elo0 E  --elo1 E  --alpha A  --beta B\n"
+              << "tune options:    --epochs N  --threads N  --lr X  --k K  --out PATH\n"
+              << "analyze options: --multipv N  --depth D  --time SEC  --nodes N  --hash MB\n"
+              << "datagen options: --positions N  --threads N  --depth D  --nodes N  --time SEC  --plies N\n"
+              << "                 --max-plies N  --chunk N  --hash MB  --seed N\n"
+              << "perft options:   --depth D (1-4, default 4)\n"
+              << "ADDR is host:port, unix:/path or stdio (worker only)\n";
+}
+
+static int runDemo() {
     ChessEngine engine;
+    engine.setHashSize(DEFAULT_HASH_MB);
     Board board;
     engine.initBoard(board);
 
     std::cout << "=== Welcome to the Updated C++ Chess Engine Demo ===\n";
     std::cout << "Initializing standard board...\n";
 
-    
+
     Move best = engine.findBestMove(board, MAX_DEPTH, 5.0);
 
     std::cout << "Engine suggests move: ("
-              << best.fromRow << ", " << best.fromCol << ") -> ("
-              << best.toRow   << ", " << best.toCol << ")";
-    if (best.promotion != EMPTY) {
-        std::cout << " promotion to " << best.promotion;
+              << best.fromRow() << ", " << best.fromCol() << ") -> ("
+              << best.toRow()   << ", " << best.toCol() << ")";
+    if (best.promotion() != EMPTY) {
+        std::cout << " promotion to " << best.promotion();
     }
     std::cout << std::endl;
 
-    
-    Piece captured = board.squares[best.toRow][best.toCol];
+
+    Piece captured = board.squares[best.toRow()][best.toCol()];
     engine.makeMove(board, best);
 
-    
+
     std::cout << "\nBoard after engine's move:\n";
     for (int r = 0; r < BOARD_SIZE; ++r) {
         for (int c = 0; c < BOARD_SIZE; ++c) {
@@ -35,3 +64,265 @@ int main() {
 
     return 0;
 }
+
+static int runMatchMode(int argc, char **argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    MatchConfig config;
+    config.engineA = argv[2];
+    config.engineB = argv[3];
+    for (int i = 4; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (opt == "--games") {
+            config.games = std::atoi(value);
+        } else if (opt == "--concurrency") {
+            config.concurrency = std::atoi(value);
+        } else if (opt == "--depth") {
+            config.depth = std::atoi(value);
+        } else if (opt == "--time") {
+            config.timeLimit = std::atof(value);
+        } else if (opt == "--nodes") {
+            config.nodeLimit = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--plies") {
+            config.openingPlies = std::atoi(value);
+        } else if (opt == "--max-plies") {
+            config.maxPlies = std::atoi(value);
+        } else if (opt == "--seed") {
+            config.seed = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--elo0") {
+            config.elo0 = std::atof(value);
+        } else if (opt == "--elo1") {
+            config.elo1 = std::atof(value);
+        } else if (opt == "--alpha") {
+            config.alpha = std::atof(value);
+        } else if (opt == "--beta") {
+            config.beta = std::atof(value);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    return runMatch(config);
+}
+
+static int runTuneMode(int argc, char **argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    TunerConfig config;
+    config.dataset = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (opt == "--epochs") {
+            config.epochs = std::atoi(value);
+        } else if (opt == "--threads") {
+            config.threads = std::atoi(value);
+        } else if (opt == "--lr") {
+            config.learningRate = std::atof(value);
+        } else if (opt == "--k") {
+            config.k = std::atof(value);
+        } else if (opt == "--out") {
+            config.output = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    return runTuner(config);
+}
+
+static int runAnalyzeMode(int argc, char **argv) {
+    SearchLimits limits;
+    size_t hashMb = DEFAULT_HASH_MB;
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (opt == "--multipv") {
+            limits.multiPV = std::atoi(value);
+        } else if (opt == "--depth") {
+            limits.maxDepth = std::atoi(value);
+        } else if (opt == "--time") {
+            limits.timeLimit = std::atof(value);
+        } else if (opt == "--nodes") {
+            limits.nodeLimit = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--hash") {
+            hashMb = static_cast<size_t>(std::atoi(value));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    EngineCore core;
+    SearchContext context(core);
+    context.setHashSize(hashMb);
+    std::string fen;
+    while (std::getline(std::cin, fen)) {
+        Board board;
+        if (!boardFromFen(fen, board)) {
+            std::cerr << "analyze: bad FEN: " << fen << "\n";
+            continue;
+        }
+        std::cout << "position " << fen << "\n";
+        Move best = context.findBestMove(board, limits, [&](const SearchStats &stats, const Move &) {
+            const auto &lines = context.getLastLines();
+            for (size_t k = 0; k < lines.size(); ++k) {
+                std::cout << "info depth " << stats.depth << " multipv " << k + 1 << " score " << lines[k].score
+                          << " nodes " << stats.nodes << " pv";
+                for (const Move &m : lines[k].pv) std::cout << " " << moveToString(m);
+                std::cout << "\n";
+            }
+        });
+        std::cout << "bestmove " << (best == Move() ? "none" : moveToString(best)) << std::endl;
+    }
+    return 0;
+}
+
+static int runDatagenMode(int argc, char **argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    DatagenConfig config;
+    config.output = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (opt == "--positions") {
+            config.positions = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--threads") {
+            config.threads = std::atoi(value);
+        } else if (opt == "--depth") {
+            config.depth = std::atoi(value);
+        } else if (opt == "--nodes") {
+            config.nodeLimit = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--time") {
+            config.timeLimit = std::atof(value);
+        } else if (opt == "--plies") {
+            config.openingPlies = std::atoi(value);
+        } else if (opt == "--max-plies") {
+            config.maxPlies = std::atoi(value);
+        } else if (opt == "--chunk") {
+            config.chunkPositions = std::strtoull(value, nullptr, 10);
+        } else if (opt == "--hash") {
+            config.hashMb = static_cast<size_t>(std::atoi(value));
+        } else if (opt == "--seed") {
+            config.seed = std::strtoull(value, nullptr, 10);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (config.chunkPositions == 0) config.chunkPositions = 1;
+    return runDatagen(config);
+}
+
+static int runPerftMode(int argc, char **argv) {
+    int depth = 4;
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (opt == "--depth") {
+            depth = std::atoi(value);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    return runPerft(depth);
+}
+
+static int runClusterMode(int argc, char **argv) {
+    std::string mode = argv[1];
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    ClusterConfig config;
+    config.address = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (opt == "--split") {
+            config.splitRoot = true;
+        } else if (opt == "--workers" && hasValue) {
+            config.spawnWorkers = std::atoi(argv[++i]);
+        } else if (opt == "--depth" && hasValue) {
+            config.depth = std::atoi(argv[++i]);
+        } else if (opt == "--time" && hasValue) {
+            config.timeLimit = std::atof(argv[++i]);
+        } else if (opt == "--nodes" && hasValue) {
+            config.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (opt == "--hash" && hasValue) {
+            config.hashMb = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if (opt == "--heartbeat" && hasValue) {
+            config.heartbeatMs = std::atoi(argv[++i]);
+        } else if (opt == "--timeout" && hasValue) {
+            config.workerTimeoutMs = std::atoi(argv[++i]);
+        } else if (opt == "--queue" && hasValue) {
+            config.maxQueuedJobs = static_cast<size_t>(std::atoi(argv[++i]));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    return (mode == "--coordinator") ? runCoordinator(config) : runWorker(config);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        return runDemo();
+    }
+
+    std::string mode = argv[1];
+    if (mode == "--coordinator" || mode == "--worker") {
+        return runClusterMode(argc, argv);
+    }
+    if (mode == "--match") {
+        return runMatchMode(argc, argv);
+    }
+    if (mode == "--tune") {
+        return runTuneMode(argc, argv);
+    }
+    if (mode == "--analyze") {
+        return runAnalyzeMode(argc, argv);
+    }
+    if (mode == "--datagen") {
+        return runDatagenMode(argc, argv);
+    }
+    if (mode == "--perft") {
+        return runPerftMode(argc, argv);
+    }
+    printUsage();
+    return 1;
+}
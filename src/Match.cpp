@@ -0,0 +1,335 @@
+#include "Match.h"
+#include "Cluster.h"
+#include <vector>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+// Engines heartbeat about once a second; this much silence means a hang or crash
+static const int ENGINE_TIMEOUT_MS = 5000;
+
+// Per-game score variance never goes below this in the SPRT, so an unbroken run
+// of wins, draws or losses still moves the LLR instead of dividing by zero
+static const double MIN_GAME_VARIANCE = 0.01;
+
+namespace {
+
+// An engine binary running "--worker stdio" as a child process
+class EngineProcess {
+public:
+    ~EngineProcess() { stop(); }
+
+    bool start(const std::string &path);
+    void stop();
+    bool restart();  // Kills a crashed or hung engine and starts the same binary again
+    bool search(const std::string &fen, const MatchConfig &config, std::string &move);
+    bool failed() const { return lastFailed; }
+    bool running() const { return pid > 0; }
+    const std::string &binary() const { return path; }
+
+private:
+    std::string path;
+    bool lastFailed = false;  // The last search got no answer
+    pid_t pid = -1;
+    int toChild = -1;
+    int fromChild = -1;
+    LineReader reader;
+    unsigned long long nextId = 1;
+};
+
+bool EngineProcess::start(const std::string &binary) {
+    path = binary;
+    lastFailed = false;
+    int in[2], out[2];
+    if (::pipe2(in, O_CLOEXEC) != 0) return false;
+    if (::pipe2(out, O_CLOEXEC) != 0) {
+        ::close(in[0]);
+        ::close(in[1]);
+        return false;
+    }
+
+    pid = ::fork();
+    if (pid == 0) {
+        ::dup2(in[0], STDIN_FILENO);
+        ::dup2(out[1], STDOUT_FILENO);
+        ::execl(path.c_str(), path.c_str(), "--worker", "stdio", static_cast<char *>(nullptr));
+        ::_exit(127);
+    }
+    ::close(in[0]);
+    ::close(out[1]);
+    toChild   = in[1];
+    fromChild = out[0];
+    reader    = LineReader(fromChild);
+    if (pid < 0) {
+        stop();
+        return false;
+    }
+
+    // A failed exec closes the pipe before the worker's greeting arrives
+    std::string line;
+    if (!reader.next(line, ENGINE_TIMEOUT_MS) || line.compare(0, 5, "HELLO") != 0) {
+        ::kill(pid, SIGKILL);
+        stop();
+        return false;
+    }
+    return true;
+}
+
+bool EngineProcess::restart() {
+    if (pid > 0) ::kill(pid, SIGKILL);
+    stop();
+    return start(path);
+}
+
+void EngineProcess::stop() {
+    if (toChild >= 0) {
+        writeLine(toChild, "QUIT");
+        ::close(toChild);
+    }
+    if (fromChild >= 0) ::close(fromChild);
+    if (pid > 0) ::waitpid(pid, nullptr, 0);
+    pid = -1;
+    toChild = fromChild = -1;
+}
+
+bool EngineProcess::search(const std::string &fen, const MatchConfig &config, std::string &move) {
+    unsigned long long id = nextId++;
+    std::ostringstream job;
+    job << "JOB " << id << " " << config.depth << " " << static_cast<long long>(config.timeLimit * 1000)
+        << " " << config.nodeLimit << " " << fen;
+    bool sent = writeLine(toChild, job.str());
+
+    std::string line;
+    while (sent && reader.next(line, ENGINE_TIMEOUT_MS)) {
+        std::istringstream in(line);
+        std::string cmd;
+        unsigned long long resultId;
+        in >> cmd;
+        if (cmd != "RESULT") continue;  // HELLO, HB
+        if (in >> resultId >> move && resultId == id) return true;
+    }
+    lastFailed = true;
+    return false;
+}
+
+struct GameOutcome {
+    double whiteScore;   // 1, 0.5 or 0
+    const char *reason;
+};
+
+static GameOutcome playGame(const EngineCore &rules, Board board, EngineProcess &white, EngineProcess &black,
+                            const MatchConfig &config) {
+    std::map<std::string, int> seen;
+    int halfmoveClock = 0;
+
+    for (int ply = 0;; ++ply) {
+        std::string fen = boardToFen(board);
+        auto legal = rules.generateLegalMoves(board);
+        if (legal.empty()) {
+            if (rules.isKingInCheck(board, board.whiteToMove)) {
+                return {board.whiteToMove ? 0.0 : 1.0, "checkmate"};
+            }
+            return {0.5, "stalemate"};
+        }
+        if (++seen[fen] >= 3)              return {0.5, "repetition"};
+        if (halfmoveClock >= 100)          return {0.5, "fifty moves"};
+        if (insufficientMaterial(board))   return {0.5, "insufficient material"};
+        if (ply >= config.maxPlies)        return {0.5, "max plies"};
+
+        double moverLoses = board.whiteToMove ? 0.0 : 1.0;
+        std::string text;
+        if (!(board.whiteToMove ? white : black).search(fen, config, text)) {
+            return {moverLoses, "engine failure"};
+        }
+
+        auto it = std::find_if(legal.begin(), legal.end(), [&](const Move &m) { return moveToString(m) == text; });
+        if (it == legal.end()) {
+            return {moverLoses, "illegal move"};
+        }
+
+        Piece mover = board.squares[it->fromRow()][it->fromCol()];
+        bool irreversible = (mover == WP || mover == BP || board.squares[it->toRow()][it->toCol()] != EMPTY);
+        halfmoveClock = irreversible ? 0 : halfmoveClock + 1;
+        rules.makeMove(board, *it);
+    }
+}
+
+static double scoreToElo(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+static double eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// Log-likelihood ratio of the trinomial SPRT under the normal approximation
+static double sprtLlr(int wins, int draws, int losses, double elo0, double elo1) {
+    double n = wins + draws + losses;
+    if (n == 0) return 0.0;
+    double s = (wins + 0.5 * draws) / n;
+    double var = (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / n;
+    var = std::max(var, MIN_GAME_VARIANCE);
+    double s0 = eloToScore(elo0), s1 = eloToScore(elo1);
+    return n * (s1 - s0) * (2 * s - s0 - s1) / (2 * var);
+}
+
+struct MatchState {
+    std::mutex mutex;
+    std::atomic<int> nextPair{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> engineError{false};  // An engine could not be (re)started; the result is void
+    int wins = 0, draws = 0, losses = 0;  // From engine A's point of view
+    double lowerBound, upperBound;
+};
+
+static void report(const MatchConfig &config, MatchState &state, int game, bool aWhite, const GameOutcome &outcome) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    double aScore = aWhite ? outcome.whiteScore : 1.0 - outcome.whiteScore;
+    if (aScore == 1.0) ++state.wins;
+    else if (aScore == 0.0) ++state.losses;
+    else ++state.draws;
+
+    int n = state.wins + state.draws + state.losses;
+    double s = (state.wins + 0.5 * state.draws) / n;
+    double var = (state.wins * (1 - s) * (1 - s) + state.draws * (0.5 - s) * (0.5 - s) + state.losses * s * s) / n;
+    double margin = 1.96 * std::sqrt(var / n);
+    double elo = scoreToElo(s);
+    double errElo = (scoreToElo(s + margin) - scoreToElo(s - margin)) / 2;
+    double llr = sprtLlr(state.wins, state.draws, state.losses, config.elo0, config.elo1);
+
+    std::cout << "game " << game + 1 << " (" << (aWhite ? "A-B" : "B-A") << ") "
+              << (outcome.whiteScore == 1.0 ? "1-0" : outcome.whiteScore == 0.0 ? "0-1" : "1/2-1/2")
+              << " " << outcome.reason
+              << " | W " << state.wins << " D " << state.draws << " L " << state.losses
+              << " | Elo " << elo << " +/- " << errElo
+              << " | LLR " << llr << " [" << state.lowerBound << ", " << state.upperBound << "]"
+              << std::endl;
+
+    if (llr <= state.lowerBound || llr >= state.upperBound) state.stop = true;
+}
+
+static void matchThread(const MatchConfig &config, MatchState &state, int pairs) {
+    EngineProcess a, b;
+    if (!a.start(config.engineA) || !b.start(config.engineB)) {
+        std::cerr << "match: cannot start engine " << (a.running() ? config.engineB : config.engineA) << "\n";
+        state.engineError = true;
+        state.stop = true;
+        return;
+    }
+
+    // The failed game stands as a loss, but the next one gets a fresh process
+    auto recover = [&]() {
+        for (EngineProcess *engine : {&a, &b}) {
+            if (engine->failed() && !engine->restart()) {
+                std::cerr << "match: cannot restart engine " << engine->binary() << "\n";
+                state.engineError = true;
+                state.stop = true;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    EngineCore rules;
+    for (;;) {
+        int pair = state.nextPair++;
+        if (pair >= pairs || state.stop) break;
+        Board opening = makeOpening(rules, config.seed + static_cast<uint64_t>(pair), config.openingPlies);
+
+        GameOutcome first = playGame(rules, opening, a, b, config);
+        report(config, state, 2 * pair, true, first);
+        if (!recover()) return;
+        GameOutcome second = playGame(rules, opening, b, a, config);
+        report(config, state, 2 * pair + 1, false, second);
+        if (!recover()) return;
+    }
+}
+
+} // namespace
+
+bool insufficientMaterial(const Board &board) {
+    int minors = 0;
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            switch (board.squares[r][c]) {
+                case EMPTY: case WK: case BK: break;
+                case WN: case WB: case BN: case BB: ++minors; break;
+                default: return false;
+            }
+        }
+    }
+    return minors <= 1;
+}
+
+// Random legal plies from the start position; retried until the side to move still has a move
+Board makeOpening(const EngineCore &rules, uint64_t seed, int plies) {
+    std::mt19937_64 rng(seed);
+    for (;;) {
+        Board board;
+        rules.initBoard(board);
+        bool ok = true;
+        for (int i = 0; i < plies && ok; ++i) {
+            auto legal = rules.generateLegalMoves(board);
+            if (legal.empty()) {
+                ok = false;
+                break;
+            }
+            rules.makeMove(board, legal[rng() % legal.size()]);
+        }
+        if (ok && !rules.generateLegalMoves(board).empty()) return board;
+    }
+}
+
+int runMatch(const MatchConfig &config) {
+    // A crashed engine must surface as a lost game, not a dead runner
+    ::signal(SIGPIPE, SIG_IGN);
+
+    MatchState state;
+    state.lowerBound = std::log(config.beta / (1 - config.alpha));
+    state.upperBound = std::log((1 - config.beta) / config.alpha);
+
+    int pairs = (config.games + 1) / 2;
+    int threads = config.concurrency > 0 ? config.concurrency
+                                         : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::min(threads, pairs);
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(matchThread, std::cref(config), std::ref(state), pairs);
+    }
+    for (auto &t : pool) t.join();
+
+    if (state.engineError) {
+        std::cerr << "match: aborted after " << state.wins + state.draws + state.losses
+                  << " games; an engine could not be started" << std::endl;
+        return 3;
+    }
+
+    double llr = sprtLlr(state.wins, state.draws, state.losses, config.elo0, config.elo1);
+    int n = state.wins + state.draws + state.losses;
+    std::cout << "Result: " << n << " games, W " << state.wins << " D " << state.draws << " L " << state.losses
+              << ", Elo " << (n ? scoreToElo((state.wins + 0.5 * state.draws) / n) : 0.0) << "\n";
+    std::cout << "SPRT elo0=" << config.elo0 << " elo1=" << config.elo1 << ": LLR " << llr << " -> ";
+    if (llr >= state.upperBound) {
+        std::cout << "H1 accepted" << std::endl;
+        return 0;
+    }
+    if (llr <= state.lowerBound) {
+        std::cout << "H0 accepted" << std::endl;
+        return 1;
+    }
+    std::cout << "inconclusive" << std::endl;
+    return 2;
+}
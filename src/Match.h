@@ -0,0 +1,39 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include "Engine.h"
+#include <string>
+#include <cstdint>
+
+// Self-play match between two engine builds, each run as "<binary> --worker stdio".
+// Games come in balanced pairs: every random opening is played once with each colour.
+struct MatchConfig {
+    std::string engineA;             // Candidate build
+    std::string engineB;             // Baseline build
+    int      games        = 200;     // Rounded up to whole pairs
+    int      concurrency  = 0;       // Games in flight; 0 = one per hardware thread
+    int      depth        = MAX_DEPTH;
+    double   timeLimit    = 0.1;     // Per move
+    uint64_t nodeLimit    = 0;       // Per move; 0 = no node budget
+    int      openingPlies = 8;       // Random plies played before the engines take over
+    int      maxPlies     = 400;     // Games still running here are adjudicated drawn
+    uint64_t seed         = 1;
+
+    // SPRT on logistic Elo of A over B; the defaults gate against a regression
+    double elo0  = -5.0;
+    double elo1  =  0.0;
+    double alpha = 0.05;
+    double beta  = 0.05;
+};
+
+// Random legal plies from the start position; the side to move always has a reply
+Board makeOpening(const EngineCore &rules, uint64_t seed, int plies);
+
+// Bare kings, or a single minor piece: no mate is possible
+bool insufficientMaterial(const Board &board);
+
+// Returns 0 when H1 is accepted, 1 when H0 is accepted, 2 when inconclusive,
+// 3 when an engine cannot be started or restarted (no verdict is given).
+int runMatch(const MatchConfig &config);
+
+#endif
@@ -0,0 +1,91 @@
+#include "Perft.h"
+#include <chrono>
+
+namespace {
+
+constexpr int PERFT_MAX_DEPTH = 4;
+
+struct PerftPosition {
+    const char *fen;
+    uint64_t nodes[PERFT_MAX_DEPTH];  // Leaf counts at depth 1..PERFT_MAX_DEPTH
+};
+
+// Counts from the move generator before the attack-table and packed-move rewrites
+const PerftPosition PERFT_POSITIONS[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w",                 {12, 144, 2124, 31250}},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w",     {44, 1740, 77305, 3034989}},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w",                             {12, 148, 2012, 29373}},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w",       {5, 208, 6767, 285721}},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w",              {39, 1128, 42036, 1238036}},
+    {"4k3/1P6/8/8/8/8/6p1/4K3 b",                                     {9, 61, 606, 6046}},
+};
+
+bool sameBoard(const Board &a, const Board &b) {
+    if (a.whiteToMove != b.whiteToMove) return false;
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            if (a.squares[r][c] != b.squares[r][c]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t perft(const EngineCore &core, Board &board, int depth, bool &consistent) {
+    if (depth == 0) return 1;
+    std::vector<Move> moves = core.generateLegalMoves(board);
+    uint64_t hash = core.computeZobristHash(board);
+    uint64_t nodes = 0;
+    for (const Move &m : moves) {
+        Board before = board;
+        Piece captured = board.squares[m.toRow()][m.toCol()];
+        uint64_t expected = core.hashAfterMove(board, hash, m);
+        core.makeMove(board, m);
+        if (expected != core.computeZobristHash(board)) {
+            std::cerr << "perft: incremental hash differs after " << moveToString(m) << " in "
+                      << boardToFen(before) << "\n";
+            consistent = false;
+        }
+        nodes += depth == 1 ? 1 : perft(core, board, depth - 1, consistent);
+        core.undoMove(board, m, captured);
+        if (!sameBoard(before, board)) {
+            std::cerr << "perft: undoMove does not restore " << boardToFen(before) << " after "
+                      << moveToString(m) << "\n";
+            consistent = false;
+            board = before;
+        }
+    }
+    return nodes;
+}
+
+int runPerft(int depth) {
+    if (depth < 1 || depth > PERFT_MAX_DEPTH) {
+        std::cerr << "perft: depth must be 1-" << PERFT_MAX_DEPTH << "\n";
+        return 1;
+    }
+
+    EngineCore core;
+    int failures = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const PerftPosition &position : PERFT_POSITIONS) {
+        Board board;
+        if (!boardFromFen(position.fen, board)) {
+            std::cerr << "perft: bad FEN: " << position.fen << "\n";
+            ++failures;
+            continue;
+        }
+        bool consistent = true;
+        uint64_t nodes = perft(core, board, depth, consistent);
+        uint64_t expected = position.nodes[depth - 1];
+        bool ok = consistent && nodes == expected;
+        if (!ok) ++failures;
+        std::cout << (ok ? "ok   " : "FAIL ") << position.fen << " depth " << depth << " nodes " << nodes;
+        if (nodes != expected) std::cout << " expected " << expected;
+        std::cout << "\n";
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << (failures ? "perft FAILED" : "perft passed") << " in " << elapsed << " s" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,18 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Engine.h"
+#include <cstdint>
+
+// Move generator self-check. Counts the leaves of the legal move tree of a
+// few fixed positions and compares them with known counts; along the way
+// every move's hashAfterMove must equal a fresh computeZobristHash and
+// undoMove must restore the board exactly. The counts are specific to this
+// move generator (no castling, en passant or double pawn push), so they do
+// not match published perft tables.
+uint64_t perft(const EngineCore &core, Board &board, int depth, bool &consistent);
+
+// Runs the built-in positions to depth (1-4); returns 0 if every count and check passes
+int runPerft(int depth);
+
+#endif
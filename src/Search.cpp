@@ -0,0 +1,344 @@
+#include "Engine.h"
+#include <algorithm>
+
+// MultiPV root floor below last iteration's worst line, widened on a fail low
+static const int ASPIRATION_WINDOW = 100;
+
+
+SearchContext::SearchContext(const EngineCore &core)
+    : core(core), tTable(core.sharedTable() ? core.sharedTable() : &ownTable), hashMb(CONTEXT_HASH_MB),
+      timeLimitSec(DEFAULT_TIME_LIMIT), nodeLimit(0), stopRequested(false), aborted(false), nodes(0), lastStats{0, 0, 0, 0.0} {
+}
+
+SearchContext::~SearchContext() {
+    stop();
+    wait();
+}
+
+void SearchContext::setHashSize(size_t megabytes) {
+    hashMb = megabytes;
+    if (tTable == &ownTable && !ownTable.empty()) ownTable.resize(hashMb);
+}
+
+
+int SearchContext::quiescenceSearch(Board &board, int alpha, int beta) {
+    ++nodes;
+    // Evaluate current position
+    int standPat = core.evaluate(board);
+    if (standPat >= beta) {
+        return beta;
+    }
+    if (standPat > alpha) {
+        alpha = standPat;
+    }
+
+    
+    std::vector<Move> moves;
+    {
+        auto pseudo = core.generatePseudoLegalMoves(board);
+        
+        for (auto &m: pseudo) {
+            if (board.squares[m.toRow()][m.toCol()] != EMPTY) {
+                moves.push_back(m);
+            }
+        }
+    }
+
+    
+    core.sortMoves(board, moves);
+
+    for (auto &m : moves) {
+        Piece captured = board.squares[m.toRow()][m.toCol()];
+        core.makeMove(board, m);
+        if (!core.isKingInCheck(board, board.whiteToMove ? false : true)) {
+            int score = -quiescenceSearch(board, -beta, -alpha);
+            core.undoMove(board, m, captured);
+
+            if (score >= beta) {
+                return beta;
+            }
+            if (score > alpha) {
+                alpha = score;
+            }
+        } else {
+            core.undoMove(board, m, captured);
+        }
+    }
+    return alpha;
+}
+
+
+int SearchContext::alphaBeta(Board &board, uint64_t hash, int alpha, int beta, int depth, bool doNullMove) {
+    ++nodes;
+    if (depth == 0) {
+        
+        return quiescenceSearch(board, alpha, beta);
+    }
+
+    // Once aborted, every score up the tree is partial: callers discard it and nothing is stored
+    if (aborted || timeIsUp()) {
+        return 0;
+    }
+
+    int alphaOrig = alpha;
+    Move ttMove;
+    TTEntry entry;
+    if (tTable->probe(hash, entry)) {
+        ttMove = Move(entry.bestMove);
+        if (entry.depth >= depth) {
+            if (entry.flag == 0)  return entry.score;
+            if (entry.flag == -1) beta  = std::min(beta,  entry.score);  // Upper bound
+            if (entry.flag ==  1) alpha = std::max(alpha, entry.score);  // Lower bound
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    // Generate legal moves
+    std::vector<Move> moves = core.generateLegalMoves(board);
+    if (moves.empty()) {
+        // no moves => checkmate or stalemate
+        if (core.isKingInCheck(board, board.whiteToMove)) {
+            // checkmate
+            return matedScore(depth);
+        } else {
+            // stalemate
+            return 0;
+        }
+    }
+
+    // Move ordering: TT move first, then captures by MVV-LVA
+    core.sortMoves(board, moves);
+    if (ttMove != Move()) {
+        auto tt = std::find(moves.begin(), moves.end(), ttMove);
+        if (tt != moves.end()) std::rotate(moves.begin(), tt, tt + 1);
+    }
+
+    bool isPV = false;
+    int bestValue = -INFINITY_SCORE;
+    Move bestMove;
+    for (auto &m : moves) {
+        Piece captured = board.squares[m.toRow()][m.toCol()];
+        uint64_t childHash = core.hashAfterMove(board, hash, m);
+        if (depth > 1) tTable->prefetch(childHash);
+        core.makeMove(board, m);
+        int score = -alphaBeta(board, childHash, -beta, -alpha, depth - 1);
+        core.undoMove(board, m, captured);
+        if (aborted) {
+            return 0;
+        }
+
+        if (score > bestValue) {
+            bestValue = score;
+            bestMove = m;
+            if (score > alpha) {
+                alpha = score;
+                isPV = true;
+                if (alpha >= beta) {
+                    break; 
+                }
+            }
+        }
+    }
+
+    
+    TTEntry newEntry;
+    newEntry.score = bestValue;
+    newEntry.bestMove = bestMove.data;
+    newEntry.depth = static_cast<int8_t>(depth);
+    // Bound type against the window this node was entered with; alpha has moved since
+    if (bestValue <= alphaOrig) newEntry.flag = -1; // alpha
+    else if (bestValue >= beta) newEntry.flag =  1; // beta
+    else newEntry.flag = 0;                         // exact
+    tTable->store(hash, newEntry);
+
+    return bestValue;
+}
+
+// Search the root moves not yet in lines, in order, adding those that score above
+// floor; lines stays best first and at most slots long. Once it is full, alpha is
+// the worst ranked score, so a move only costs a full search if it would make the list.
+int SearchContext::searchRoot(Board &board, uint64_t hash, int depth, const std::vector<Move> &moves,
+                              size_t slots, int floor, std::vector<PVLine> &lines) {
+    int alpha = lines.size() == slots ? lines.back().score : floor;
+    int beta  = INFINITY_SCORE;
+
+    for (auto &m : moves) {
+        if (std::any_of(lines.begin(), lines.end(), [&](const PVLine &l) { return l.move == m; })) continue;
+        Piece captured = board.squares[m.toRow()][m.toCol()];
+        uint64_t childHash = core.hashAfterMove(board, hash, m);
+        if (depth > 1) tTable->prefetch(childHash);
+        core.makeMove(board, m);
+        int score = -alphaBeta(board, childHash, -beta, -alpha, depth - 1);
+        core.undoMove(board, m, captured);
+        // Depth 1 children go straight to quiescence, so their scores are always complete
+        if (aborted && depth > 1) break;
+
+        if (score > alpha) {
+            auto pos = std::find_if(lines.begin(), lines.end(), [&](const PVLine &l) { return score > l.score; });
+            lines.insert(pos, PVLine{m, score, {}});
+            if (lines.size() > slots) lines.pop_back();
+            if (lines.size() == slots) alpha = lines.back().score;
+        }
+        if (timeIsUp()) break;
+    }
+
+    return lines.empty() ? -INFINITY_SCORE : lines.front().score;
+}
+
+// Follows TT best moves from the root, stopping at a missing, illegal or repeated entry
+std::vector<Move> SearchContext::extractPV(Board board, uint64_t hash, const Move &first, int maxLength) const {
+    std::vector<Move> pv;
+    std::vector<uint64_t> visited{hash};
+    Move next = first;
+    while (next != Move() && static_cast<int>(pv.size()) < maxLength) {
+        auto legal = core.generateLegalMoves(board);
+        if (std::find(legal.begin(), legal.end(), next) == legal.end()) break;
+        hash = core.hashAfterMove(board, hash, next);
+        core.makeMove(board, next);
+        pv.push_back(next);
+        if (std::find(visited.begin(), visited.end(), hash) != visited.end()) break;
+        visited.push_back(hash);
+
+        TTEntry entry;
+        next = tTable->probe(hash, entry) ? Move(entry.bestMove) : Move();
+    }
+    return pv;
+}
+
+
+// stop() only reaches a search in progress, so the flag is cleared on the way in and out
+Move SearchContext::findBestMove(Board &board, const SearchLimits &limits, const ProgressCallback &progress) {
+    stopRequested = false;
+    Move best = runSearch(board, limits, progress);
+    stopRequested = false;
+    return best;
+}
+
+Move SearchContext::runSearch(Board &board, const SearchLimits &limits, const ProgressCallback &progress) {
+    timeLimitSec = limits.timeLimit;
+    nodeLimit = limits.nodeLimit;
+    startTime = std::chrono::steady_clock::now();
+    nodes = 0;
+    aborted = false;
+    lastStats = SearchStats{0, 0, 0, 0.0};
+    lastLines.clear();
+    if (tTable->empty()) tTable->resize(hashMb);
+
+    uint64_t hash = core.computeZobristHash(board);
+    Move bestMove;
+    // Iterative deepening
+    for (int depth = 1; depth <= limits.maxDepth; ++depth) {
+        if (depth > 1 && timeIsUp()) break; 
+
+        // Move ordering: last iteration's ranking first, the rest by MVV-LVA
+        auto rootMoves = core.generateLegalMoves(board);
+        if (rootMoves.empty()) break;
+        core.sortMoves(board, rootMoves);
+        for (auto it = lastLines.rbegin(); it != lastLines.rend(); ++it) {
+            auto m = std::find(rootMoves.begin(), rootMoves.end(), it->move);
+            if (m != rootMoves.end()) std::rotate(rootMoves.begin(), m, m + 1);
+        }
+
+        size_t slots = std::min(rootMoves.size(), static_cast<size_t>(std::max(1, limits.multiPV)));
+        // With several lines, start just below last iteration's worst one so moves that
+        // cannot make the list fail low cheaply; widen and search the rest again while
+        // too few clear the floor. Scores above the floor are exact at any width.
+        int floor = -INFINITY_SCORE;
+        int window = ASPIRATION_WINDOW;
+        if (slots > 1 && lastLines.size() == slots && std::abs(lastLines.back().score) < MATE_SCORE - 1000) {
+            floor = lastLines.back().score - window;
+        }
+        std::vector<PVLine> lines;
+        searchRoot(board, hash, depth, rootMoves, slots, floor, lines);
+        while (lines.size() < slots && floor > -INFINITY_SCORE && !(aborted && depth > 1)) {
+            window *= 4;
+            floor = window > ASPIRATION_WINDOW * 64 ? -INFINITY_SCORE : floor - window;
+            searchRoot(board, hash, depth, rootMoves, slots, floor, lines);
+        }
+        // Depth 1 always counts, so a tight budget still yields a legal move
+        if (aborted && depth > 1) break;
+        for (auto &line : lines) line.pv = extractPV(board, hash, line.move, depth);
+
+        lastLines = std::move(lines);
+        bestMove = lastLines.front().move;
+        lastStats.score = lastLines.front().score;
+        lastStats.depth = depth;
+        if (progress) {
+            lastStats.nodes = nodes;
+            lastStats.elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            progress(lastStats, bestMove);
+        }
+    }
+    lastStats.nodes = nodes;
+    lastStats.elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return bestMove;
+}
+
+
+// Sets aborted the first time a limit is hit; the search then unwinds without trusting scores
+bool SearchContext::timeIsUp() {
+    if (stopRequested.load(std::memory_order_relaxed) || (nodeLimit && nodes >= nodeLimit)) {
+        aborted = true;
+        return true;
+    }
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - startTime).count();
+    if (elapsed >= timeLimitSec) aborted = true;
+    return aborted;
+}
+
+
+void SearchContext::startSearch(const Board &board, const SearchLimits &limits, ProgressCallback progress) {
+    wait();
+    stopRequested = false;
+    asyncBoard = board;
+    // Cleared here rather than in the thread, so a stop() right after startSearch is not lost
+    searchThread = std::thread([this, limits, progress]() {
+        asyncResult = runSearch(asyncBoard, limits, progress);
+        stopRequested = false;
+    });
+}
+
+void SearchContext::stop() {
+    stopRequested = true;
+}
+
+Move SearchContext::wait() {
+    if (searchThread.joinable()) searchThread.join();
+    stopRequested = false;
+    return asyncResult;
+}
+
+
+ContextPool::ContextPool(const EngineCore &core, size_t hashMbPerContext)
+    : core(core), hashMb(hashMbPerContext) {
+}
+
+ContextPool::Lease ContextPool::acquire() {
+    std::unique_ptr<SearchContext> context;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeContexts.empty()) {
+            context = std::move(freeContexts.back());
+            freeContexts.pop_back();
+        }
+    }
+    if (!context) {
+        context.reset(new SearchContext(core));
+        context->setHashSize(hashMb);
+    }
+
+    return Lease(context.release(), [this](SearchContext *released) {
+        released->stop();
+        released->wait();
+        std::lock_guard<std::mutex> lock(mutex);
+        freeContexts.emplace_back(released);
+    });
+}
+
+size_t ContextPool::idle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return freeContexts.size();
+}
@@ -0,0 +1,199 @@
+#include "TT.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+static constexpr size_t LARGE_PAGE_SIZE = 2 * 1024 * 1024;
+static constexpr size_t CLEAR_BYTES_PER_THREAD = 16 * 1024 * 1024;  // Below this a thread costs more than it saves
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+void TranspositionTable::release() {
+    if (!mapping) return;
+#ifdef __linux__
+    ::munmap(mapping, mappingBytes);
+#else
+    std::free(mapping);
+#endif
+    mapping = nullptr;
+    buckets = nullptr;
+    mappingBytes = 0;
+    mask = 0;
+    hugetlb = false;
+}
+
+void TranspositionTable::resize(size_t megabytes, int threads) {
+    release();
+
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) count *= 2;
+    size_t bytes = count * sizeof(Bucket);
+    size_t rounded = (bytes + LARGE_PAGE_SIZE - 1) / LARGE_PAGE_SIZE * LARGE_PAGE_SIZE;
+
+#ifdef __linux__
+#ifdef MAP_HUGETLB
+    // Explicit huge pages only succeed when the admin has reserved a pool
+    void *p = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        mapping = p;
+        mappingBytes = rounded;
+        hugetlb = true;
+    }
+#endif
+    if (!mapping) {
+        // Transparent huge pages need a 2 MB aligned range, so over-map and align inside it
+        void *q = ::mmap(nullptr, rounded + LARGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (q == MAP_FAILED) {
+            std::cerr << "info string hash allocation of " << megabytes << " MB failed\n";
+            if (megabytes > 1) resize(megabytes / 2, threads);
+            return;
+        }
+        mapping = q;
+        mappingBytes = rounded + LARGE_PAGE_SIZE;
+    }
+    uintptr_t base = reinterpret_cast<uintptr_t>(mapping);
+    uintptr_t aligned = (base + LARGE_PAGE_SIZE - 1) & ~(LARGE_PAGE_SIZE - 1);
+#ifdef MADV_HUGEPAGE
+    if (!hugetlb) ::madvise(reinterpret_cast<void *>(aligned), rounded, MADV_HUGEPAGE);
+#endif
+    buckets = reinterpret_cast<Bucket *>(aligned);
+#else
+    mapping = std::aligned_alloc(LARGE_PAGE_SIZE, rounded);
+    if (!mapping) {
+        std::cerr << "info string hash allocation of " << megabytes << " MB failed\n";
+        if (megabytes > 1) resize(megabytes / 2, threads);
+        return;
+    }
+    mappingBytes = rounded;
+    buckets = static_cast<Bucket *>(mapping);
+#endif
+
+    mask = count - 1;
+    clear(threads);
+    reportPages();
+}
+
+void TranspositionTable::clear(int threads) {
+    if (!buckets) return;
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, sizeBytes() / CLEAR_BYTES_PER_THREAD)));
+
+    size_t count = mask + 1;
+    if (threads == 1) {
+        std::memset(static_cast<void *>(buckets), 0, count * sizeof(Bucket));
+        return;
+    }
+
+    // Each thread zeroes its own slice
+    size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        size_t begin = t * chunk;
+        if (begin >= count) break;
+        size_t end = std::min(count, begin + chunk);
+        pool.emplace_back([this, begin, end]() {
+            std::memset(static_cast<void *>(buckets + begin), 0, (end - begin) * sizeof(Bucket));
+        });
+    }
+    for (auto &th : pool) th.join();
+}
+
+// Reports, for the first table allocated in the process, whether 2 MB pages back it
+void TranspositionTable::reportPages() const {
+    static std::atomic<bool> reported(false);
+    if (reported.exchange(true)) return;
+
+    size_t mb = sizeBytes() / (1024 * 1024);
+    std::cerr << "info string hash " << (mb ? mb : 1) << " MB, large pages: ";
+    if (hugetlb) {
+        std::cerr << "yes (hugetlbfs)\n";
+        return;
+    }
+
+    size_t hugeKb = 0;
+#ifdef __linux__
+    // AnonHugePages in the matching smaps entry tells what THP actually delivered
+    std::ifstream smaps("/proc/self/smaps");
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buckets);
+    std::string line;
+    bool inRange = false;
+    while (std::getline(smaps, line)) {
+        unsigned long long lo, hi;
+        char dash;
+        std::istringstream in(line);
+        if (line.find(':') > line.find(' ') && (in >> std::hex >> lo >> dash >> hi) && dash == '-') {
+            inRange = (addr >= lo && addr < hi);
+            continue;
+        }
+        if (inRange && line.compare(0, 14, "AnonHugePages:") == 0) {
+            hugeKb = std::strtoull(line.c_str() + 14, nullptr, 10);
+            break;
+        }
+    }
+#endif
+    if (hugeKb) {
+        std::cerr << "yes (transparent, " << hugeKb / 1024 << " of " << sizeBytes() / (1024 * 1024) << " MB)\n";
+    } else {
+        std::cerr << "no\n";
+    }
+}
+
+static_assert(sizeof(TTEntry) == sizeof(uint64_t), "TTEntry must fit one slot word");
+
+static uint64_t packEntry(const TTEntry &entry) {
+    uint64_t bits;
+    std::memcpy(&bits, &entry, sizeof(bits));
+    return bits;
+}
+
+static TTEntry unpackEntry(uint64_t bits) {
+    TTEntry entry;
+    std::memcpy(&entry, &bits, sizeof(entry));
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) const {
+    const Bucket &bucket = buckets[key & mask];
+    for (const Slot &slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+            entry = unpackEntry(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Same position overwrites in place; otherwise an empty or the shallowest slot is replaced
+void TranspositionTable::store(uint64_t key, const TTEntry &entry) {
+    Bucket &bucket = buckets[key & mask];
+    Slot *victim = &bucket.slots[0];
+    int victimDepth = INT8_MAX;
+    for (Slot &slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t slotKey = slot.keyXorData.load(std::memory_order_relaxed) ^ data;
+        if (slotKey == key || (data == 0 && slotKey == 0)) {
+            victim = &slot;
+            break;
+        }
+        int depth = unpackEntry(data).depth;
+        if (depth < victimDepth) {
+            victim = &slot;
+            victimDepth = depth;
+        }
+    }
+    uint64_t data = packEntry(entry);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
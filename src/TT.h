@@ -0,0 +1,67 @@
+#ifndef TT_H
+#define TT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+// Search result cached per position; flag is 0 exact, -1 alpha, 1 beta
+struct TTEntry {
+    int32_t score;
+    uint16_t bestMove;  // Packed Move; 0 when the node had no best move
+    int8_t  flag;
+    int8_t  depth;
+};
+
+// Fixed-size transposition table. Four 16-byte slots share one 64-byte
+// bucket so a probe touches a single cache line. The table is backed by
+// 2 MB pages where the OS allows it. clear() zeroes it with one short-lived,
+// unpinned helper thread per 16 MB, which speeds up large clears; pages land
+// on whichever NUMA nodes those helpers ran on, not the searchers' nodes.
+//
+// Probes and stores may race across threads: each slot keeps key ^ data
+// next to data, so a torn slot fails the key check instead of returning
+// another position's entry.
+class TranspositionTable {
+public:
+    TranspositionTable() = default;
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    // (Re)allocates and clears; threads = 0 uses every hardware thread
+    void resize(size_t megabytes, int threads = 0);
+    void clear(int threads = 0);
+
+    bool probe(uint64_t key, TTEntry &entry) const;
+    void store(uint64_t key, const TTEntry &entry);
+
+    // Issue the bucket load early, e.g. right after a child's key is known
+    void prefetch(uint64_t key) const {
+        __builtin_prefetch(&buckets[key & mask]);
+    }
+
+    bool empty() const { return buckets == nullptr; }
+    size_t sizeBytes() const { return (mask + 1) * sizeof(Bucket); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> keyXorData;  // 0 with data 0 marks an empty slot
+        std::atomic<uint64_t> data;        // TTEntry bits
+    };
+    static constexpr int BUCKET_SLOTS = 4;
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SLOTS];
+    };
+
+    void release();
+    void reportPages() const;
+
+    Bucket *buckets = nullptr;
+    size_t  mask = 0;
+    void   *mapping = nullptr;   // What was actually mapped; buckets is aligned inside it
+    size_t  mappingBytes = 0;
+    bool    hugetlb = false;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TABLES_H
+#define TABLES_H
+
+#include "Engine.h"
+#include "EvalParams.h"
+#include <cstdint>
+
+// Lookup tables built by the compiler. They live in read-only data shared by
+// every EngineCore, so constructing an engine does no table work at all.
+// Squares are indexed row * 8 + col, as in the Board mailbox.
+
+// splitmix64; a constexpr PRNG so the Zobrist keys can be generated at compile time
+constexpr uint64_t splitMix64(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct ZobristKeys {
+    uint64_t keys[64][13];  // [square][piece]; the EMPTY column is never used
+};
+
+constexpr ZobristKeys makeZobristKeys(uint64_t seed) {
+    ZobristKeys z{};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int p = 0; p < 13; ++p) {
+            z.keys[sq][p] = splitMix64(seed);
+        }
+    }
+    return z;
+}
+
+static constexpr ZobristKeys ZOBRIST = makeZobristKeys(0xDEADBEAF12345678ULL);
+
+// Knight, king and pawn-capture targets as bitboards over the mailbox squares
+struct AttackMasks {
+    uint64_t knight[64];
+    uint64_t king[64];
+    uint64_t pawn[2][64];  // [0] White pawn on sq captures these, [1] Black
+};
+
+constexpr uint64_t squareBit(int r, int c) {
+    return (r >= 0 && r < 8 && c >= 0 && c < 8) ? 1ULL << (r * 8 + c) : 0;
+}
+
+constexpr AttackMasks makeAttackMasks() {
+    AttackMasks m{};
+    const int knightSteps[8][2] = {{-2, -1}, {-2, 1}, {2, -1}, {2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}};
+    const int kingSteps[8][2]   = {{1, 0}, {1, 1}, {1, -1}, {0, 1}, {0, -1}, {-1, 0}, {-1, 1}, {-1, -1}};
+    for (int sq = 0; sq < 64; ++sq) {
+        int r = sq / 8, c = sq % 8;
+        for (int i = 0; i < 8; ++i) {
+            m.knight[sq] |= squareBit(r + knightSteps[i][0], c + knightSteps[i][1]);
+            m.king[sq]   |= squareBit(r + kingSteps[i][0], c + kingSteps[i][1]);
+        }
+        m.pawn[0][sq] = squareBit(r + 1, c - 1) | squareBit(r + 1, c + 1);
+        m.pawn[1][sq] = squareBit(r - 1, c - 1) | squareBit(r - 1, c + 1);
+    }
+    return m;
+}
+
+static constexpr AttackMasks ATTACKS = makeAttackMasks();
+
+// Squares walked from each square in each direction, nearest first.
+// Directions 0-3 are orthogonal (rook), 4-7 diagonal (bishop).
+constexpr int RAY_DIRECTIONS = 8;
+struct RayTable {
+    int8_t squares[64][RAY_DIRECTIONS][7];
+    int8_t length[64][RAY_DIRECTIONS];
+};
+
+constexpr RayTable makeRayTable() {
+    RayTable t{};
+    const int steps[RAY_DIRECTIONS][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int d = 0; d < RAY_DIRECTIONS; ++d) {
+            int r = sq / 8 + steps[d][0], c = sq % 8 + steps[d][1];
+            int n = 0;
+            for (; r >= 0 && r < 8 && c >= 0 && c < 8; r += steps[d][0], c += steps[d][1]) {
+                t.squares[sq][d][n++] = static_cast<int8_t>(r * 8 + c);
+            }
+            t.length[sq][d] = static_cast<int8_t>(n);
+        }
+    }
+    return t;
+}
+
+static constexpr RayTable RAYS = makeRayTable();
+
+// Material plus piece-square bonus per piece and square, White-positive,
+// with the Black halves mirrored from EvalParams.h. Builds before the tuner
+// gave Black pieces no piece-square bonus at all, so their evaluations are
+// not comparable with these.
+struct PieceSquareTable {
+    int value[13][64];
+};
+
+constexpr PieceSquareTable makePieceSquareTable() {
+    PieceSquareTable t{};
+    for (int p = WP; p <= BK; ++p) {
+        for (int sq = 0; sq < 64; ++sq) {
+            int mirrored = (7 - sq / 8) * 8 + sq % 8;
+            int bonus = 0;
+            if (p == WP) bonus =  pawnTable[sq];
+            if (p == WN) bonus =  knightTable[sq];
+            if (p == BP) bonus = -pawnTable[mirrored];
+            if (p == BN) bonus = -knightTable[mirrored];
+            t.value[p][sq] = pieceValue[p] + bonus;
+        }
+    }
+    return t;
+}
+
+static constexpr PieceSquareTable PIECE_SQUARE = makePieceSquareTable();
+
+#endif
@@ -0,0 +1,327 @@
+#include "Tuner.h"
+#include "Engine.h"
+#include "EvalParams.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Parameter vector layout; evaluate() is linear in these
+enum {
+    PARAM_MATERIAL   = 0,    // P N B R Q
+    PARAM_PAWN_PST   = 5,
+    PARAM_KNIGHT_PST = PARAM_PAWN_PST + 64,
+    PARAM_COUNT      = PARAM_KNIGHT_PST + 64
+};
+
+namespace {
+
+// Every position as a row of a sparse matrix with White's sign. Row i spans
+// [offsets[i], offsets[i + 1]) of index/coef; flat arrays keep the epoch
+// loop a straight streaming pass with no per-position allocation.
+struct Dataset {
+    std::vector<uint32_t> offsets{0};
+    std::vector<uint16_t> index;
+    std::vector<int8_t>   coef;
+    std::vector<float>    result;
+
+    size_t size() const { return result.size(); }
+
+    void append(const Dataset &other) {
+        uint32_t base = offsets.back();
+        for (size_t i = 1; i < other.offsets.size(); ++i) offsets.push_back(base + other.offsets[i]);
+        index.insert(index.end(), other.index.begin(), other.index.end());
+        coef.insert(coef.end(), other.coef.begin(), other.coef.end());
+        result.insert(result.end(), other.result.begin(), other.result.end());
+    }
+};
+
+static bool parseResult(const std::string &line, float &result) {
+    bool afterPipe = false;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t start = line.find_first_not_of(" \t", pos);
+        if (start == std::string::npos) break;
+        size_t stop = line.find_first_of(" \t", start);
+        if (stop == std::string::npos) stop = line.size();
+        pos = stop;
+
+        bool bracketed = line[start] == '[' || line[start] == '"';
+        bool pipe = (stop - start == 1 && line[start] == '|');
+        while (start < stop && std::strchr("[\"|", line[start])) ++start;
+        while (stop > start && std::strchr("]\";", line[stop - 1])) --stop;
+        const char *t = line.c_str() + start;
+        size_t len = stop - start;
+        auto is = [&](const char *word) { return len == std::strlen(word) && std::strncmp(t, word, len) == 0; };
+
+        if (is("1-0"))     { result = 1.0f; return true; }
+        if (is("0-1"))     { result = 0.0f; return true; }
+        if (is("1/2-1/2")) { result = 0.5f; return true; }
+        if (bracketed || afterPipe) {
+            if (is("1.0") || is("1")) { result = 1.0f; return true; }
+            if (is("0.5"))            { result = 0.5f; return true; }
+            if (is("0.0") || is("0")) { result = 0.0f; return true; }
+        }
+        afterPipe = pipe;
+    }
+    return false;
+}
+
+// Appends the features of board; counts of the same parameter are merged
+static void extractFeatures(const Board &board, Dataset &out) {
+    int scratch[PARAM_COUNT] = {0};
+    uint16_t touched[PARAM_COUNT];
+    int touchedCount = 0;
+    auto add = [&](int param, int sign) {
+        if (scratch[param] == 0) touched[touchedCount++] = static_cast<uint16_t>(param);
+        scratch[param] += sign;
+    };
+
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            Piece p = board.squares[r][c];
+            if (p == EMPTY || p == WK || p == BK) continue;
+            bool white = (p <= WK);
+            int sign = white ? 1 : -1;
+            int type = white ? p - WP : p - BP;  // 0 = pawn .. 4 = queen
+            int sq = white ? r * 8 + c : (7 - r) * 8 + c;
+
+            add(PARAM_MATERIAL + type, sign);
+            if (type == 0) add(PARAM_PAWN_PST + sq, sign);
+            if (type == 1) add(PARAM_KNIGHT_PST + sq, sign);
+        }
+    }
+
+    for (int i = 0; i < touchedCount; ++i) {
+        int param = touched[i];
+        if (scratch[param] == 0) continue;  // Cancelled out between the colours
+        out.index.push_back(touched[i]);
+        out.coef.push_back(static_cast<int8_t>(scratch[param]));
+    }
+    out.offsets.push_back(static_cast<uint32_t>(out.index.size()));
+}
+
+static void parseChunk(const char *begin, const char *end, Dataset &out, size_t &skipped) {
+    Board board;
+    std::string line;
+    while (begin < end) {
+        const char *nl = std::find(begin, end, '\n');
+        line.assign(begin, nl);
+        begin = (nl == end) ? end : nl + 1;
+
+        float result;
+        if (line.empty()) continue;
+        if (!boardFromFen(line, board) || !parseResult(line, result)) {
+            ++skipped;
+            continue;
+        }
+        extractFeatures(board, out);
+        out.result.push_back(result);
+    }
+}
+
+static bool loadDataset(const std::string &path, int threads, Dataset &data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Split at line boundaries and extract in parallel
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+    std::vector<const char *> cuts{begin};
+    for (int t = 1; t < threads; ++t) {
+        const char *guess = std::max(begin + text.size() * t / threads, cuts.back());
+        const char *nl = std::find(guess, end, '\n');
+        cuts.push_back(nl == end ? nl : nl + 1);
+    }
+    cuts.push_back(end);
+
+    std::vector<Dataset> parts(threads);
+    std::vector<size_t> skipped(threads, 0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back(parseChunk, cuts[t], cuts[t + 1], std::ref(parts[t]), std::ref(skipped[t]));
+    }
+    for (auto &th : pool) th.join();
+
+    size_t totalSkipped = 0;
+    for (int t = 0; t < threads; ++t) {
+        data.append(parts[t]);
+        totalSkipped += skipped[t];
+    }
+    if (totalSkipped) std::cerr << "tuner: skipped " << totalSkipped << " unparsable lines\n";
+    return true;
+}
+
+// Mean squared error of sigmoid(eval) against the results; with grad set, also
+// accumulates dLoss/dParam. Each thread owns a contiguous slice and a private
+// gradient, so the hot loop never shares a cache line.
+static double evaluateLoss(const Dataset &data, const std::vector<double> &params, double k, int threads,
+                           std::vector<double> *grad) {
+    const double scale = k * std::log(10.0) / 400.0;
+    std::vector<float> weights(params.begin(), params.end());
+    std::vector<double> losses(threads, 0.0);
+    std::vector<std::vector<double>> grads(threads, std::vector<double>(grad ? PARAM_COUNT : 0, 0.0));
+
+    size_t n = data.size();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            size_t begin = n * t / threads, end = n * (t + 1) / threads;
+            const uint32_t *offsets = data.offsets.data();
+            const uint16_t *index = data.index.data();
+            const int8_t *coef = data.coef.data();
+            const float *w = weights.data();
+            double loss = 0.0;
+            double *g = grad ? grads[t].data() : nullptr;
+
+            for (size_t i = begin; i < end; ++i) {
+                float eval = 0.0f;
+                for (uint32_t j = offsets[i]; j < offsets[i + 1]; ++j) eval += w[index[j]] * coef[j];
+                double s = 1.0 / (1.0 + std::exp(-scale * eval));
+                double err = s - data.result[i];
+                loss += err * err;
+                if (g) {
+                    double d = err * s * (1.0 - s);
+                    for (uint32_t j = offsets[i]; j < offsets[i + 1]; ++j) g[index[j]] += d * coef[j];
+                }
+            }
+            losses[t] = loss;
+        });
+    }
+    for (auto &th : pool) th.join();
+
+    double loss = 0.0;
+    for (double l : losses) loss += l;
+    if (grad) {
+        grad->assign(PARAM_COUNT, 0.0);
+        for (auto &g : grads) {
+            for (int p = 0; p < PARAM_COUNT; ++p) (*grad)[p] += g[p];
+        }
+        for (double &g : *grad) g *= 2.0 * scale / n;
+    }
+    return loss / n;
+}
+
+// Golden-section search for the K that best maps current evals to results
+static double fitK(const Dataset &data, const std::vector<double> &params, int threads) {
+    const double phi = (std::sqrt(5.0) - 1.0) / 2.0;
+    double lo = 0.05, hi = 4.0;
+    double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+    double fa = evaluateLoss(data, params, a, threads, nullptr);
+    double fb = evaluateLoss(data, params, b, threads, nullptr);
+    for (int i = 0; i < 40; ++i) {
+        if (fa < fb) {
+            hi = b; b = a; fb = fa;
+            a = hi - phi * (hi - lo);
+            fa = evaluateLoss(data, params, a, threads, nullptr);
+        } else {
+            lo = a; a = b; fa = fb;
+            b = lo + phi * (hi - lo);
+            fb = evaluateLoss(data, params, b, threads, nullptr);
+        }
+    }
+    return (lo + hi) / 2;
+}
+
+static void writeTable(std::ostream &out, const char *name, const std::vector<double> &params, int first) {
+    out << "static constexpr int " << name << "[64] = {\n";
+    for (int r = 0; r < 8; ++r) {
+        out << "  ";
+        for (int c = 0; c < 8; ++c) {
+            int sq = r * 8 + c;
+            out << std::setw(4) << std::lround(params[first + sq]) << (sq == 63 ? "" : ",");
+        }
+        out << "\n";
+    }
+    out << "};\n";
+}
+
+static bool writeHeader(const std::string &path, const std::vector<double> &params, double k, double loss,
+                        size_t positions) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "// Evaluation weights read by EngineCore::evaluate.\n"
+        << "// Regenerate with: engine --tune DATASET --out src/EvalParams.h\n"
+        << "// Tuned on " << positions << " positions, K = " << k << ", loss = " << loss << "\n"
+        << "#ifndef EVAL_PARAMS_H\n#define EVAL_PARAMS_H\n\n"
+        << "// Piece-square tables from White's side, a1 first; Black reads them mirrored\n";
+    writeTable(out, "pawnTable", params, PARAM_PAWN_PST);
+    out << "\n";
+    writeTable(out, "knightTable", params, PARAM_KNIGHT_PST);
+
+    static const char *names[] = {"P", "N", "B", "R", "Q", "K"};
+    out << "\n// Basic piece values\nstatic constexpr int pieceValue[] = {\n    0,      // EMPTY\n";
+    for (int side = 0; side < 2; ++side) {
+        for (int t = 0; t < 6; ++t) {
+            long v = (t == 5) ? 99999 : std::lround(params[PARAM_MATERIAL + t]);
+            std::string text = std::to_string(side ? -v : v);
+            if (side == 0 || t < 5) text += ",";
+            out << (side ? "   " : "    ") << std::left << std::setw(side ? 9 : 8) << text << std::right
+                << "// " << (side ? "B" : "W") << names[t] << "\n";
+        }
+    }
+    out << "};\n\n#endif\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int runTuner(const TunerConfig &config) {
+    int threads = config.threads > 0 ? config.threads
+                                     : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    auto t0 = std::chrono::steady_clock::now();
+    Dataset data;
+    if (!loadDataset(config.dataset, threads, data) || data.size() == 0) {
+        std::cerr << "tuner: no positions loaded from " << config.dataset << "\n";
+        return 1;
+    }
+    double loadSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "loaded " << data.size() << " positions (" << data.index.size() << " features) in "
+              << loadSec << " s\n";
+
+    // Start from the weights the engine currently uses
+    std::vector<double> params(PARAM_COUNT);
+    for (int t = 0; t < 5; ++t) params[PARAM_MATERIAL + t] = pieceValue[WP + t];
+    for (int sq = 0; sq < 64; ++sq) {
+        params[PARAM_PAWN_PST + sq]   = pawnTable[sq];
+        params[PARAM_KNIGHT_PST + sq] = knightTable[sq];
+    }
+
+    double k = config.k > 0 ? config.k : fitK(data, params, threads);
+    std::cout << "K = " << k << ", initial loss " << evaluateLoss(data, params, k, threads, nullptr) << "\n";
+
+    // Adam
+    const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+    std::vector<double> m(PARAM_COUNT, 0.0), v(PARAM_COUNT, 0.0), grad;
+    double loss = 0.0;
+    for (int epoch = 1; epoch <= config.epochs; ++epoch) {
+        auto e0 = std::chrono::steady_clock::now();
+        loss = evaluateLoss(data, params, k, threads, &grad);
+        for (int p = 0; p < PARAM_COUNT; ++p) {
+            m[p] = beta1 * m[p] + (1 - beta1) * grad[p];
+            v[p] = beta2 * v[p] + (1 - beta2) * grad[p] * grad[p];
+            double mHat = m[p] / (1 - std::pow(beta1, epoch));
+            double vHat = v[p] / (1 - std::pow(beta2, epoch));
+            params[p] -= config.learningRate * mHat / (std::sqrt(vHat) + eps);
+        }
+        if (epoch == 1 || epoch % 10 == 0 || epoch == config.epochs) {
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - e0).count();
+            std::cout << "epoch " << epoch << " loss " << loss << " (" << sec << " s)" << std::endl;
+        }
+    }
+
+    loss = evaluateLoss(data, params, k, threads, nullptr);
+    if (!writeHeader(config.output, params, k, loss, data.size())) {
+        std::cerr << "tuner: cannot write " << config.output << "\n";
+        return 1;
+    }
+    std::cout << "final loss " << loss << ", wrote " << config.output << "\n";
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <string>
+
+// Texel-style tuning of the weights in EvalParams.h. The dataset has one
+// position per line: a FEN followed by the game result, written as 1-0,
+// 0-1 or 1/2-1/2 (optionally quoted or bracketed), or as [1.0] / [0.5] / [0.0]
+// or "| 1.0". Results are from White's point of view.
+struct TunerConfig {
+    std::string dataset;
+    std::string output = "EvalParams.h";  // Generated header, drop-in for src/EvalParams.h
+    int    epochs       = 100;
+    int    threads      = 0;     // 0 = every hardware thread
+    double learningRate = 1.0;   // Adam step in centipawns
+    double k            = 0.0;   // Sigmoid scale; 0 fits it to the dataset first
+};
+
+int runTuner(const TunerConfig &config);
+
+#endif